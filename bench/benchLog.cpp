@@ -0,0 +1,132 @@
+/*
+ * benchLog.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ *
+ * Logging throughput from many threads at once, synchronous vs. AsyncLogger, and the cost of a single call
+ * with operator<< formatting (LOGLN) vs. deferred formatting (LOGF).
+ */
+
+#include "benchmark.h"
+
+#include <boglfw/utils/log.h>
+#include <boglfw/utils/asyncLogger.h>
+
+#include <streambuf>
+#include <ostream>
+
+static constexpr unsigned logThreads = 16;
+static constexpr unsigned linesPerThread = 256;	// per iteration
+
+// a stream that accepts everything and only counts the bytes, so the cost of the actual I/O isn't measured
+class nullBuffer : public std::streambuf {
+public:
+	uint64_t bytes = 0;
+protected:
+	int_type overflow(int_type c) override { bytes++; return traits_type::not_eof(c); }
+	std::streamsize xsputn(const char*, std::streamsize n) override { bytes += n; return n; }
+};
+
+// redirects the log into a nullBuffer for the duration of a benchmark
+class logToNull {
+public:
+	logToNull() : stream_(&buffer_) { logger::setLogStream(&stream_); }
+	~logToNull() { logger::setLogStream(nullptr); }
+private:
+	nullBuffer buffer_;
+	std::ostream stream_;
+};
+
+static void logLines(unsigned threadIndex) {
+	LOGPREFIX("bench");
+	for (unsigned i=0; i<linesPerThread; i++)
+		LOGLN("worker " << threadIndex << " processed item " << i << " in " << 0.25f * i << " ms");
+}
+
+static void logLinesDeferred(unsigned threadIndex) {
+	LOGPREFIX("bench");
+	for (unsigned i=0; i<linesPerThread; i++)
+		LOGF("worker {} processed item {} in {} ms", threadIndex, i, 0.25f * i);
+}
+
+BENCHMARK("Log/sync/threads:16") {
+	bench::ThreadTeam team(logThreads);
+	logToNull sink;
+	while (state.run())
+		team.run(logLines);
+	state.setItemsProcessed(state.iterations() * logThreads * linesPerThread);
+}
+
+// includes waiting for the writer thread at the end of each iteration, so this is the end-to-end throughput
+BENCHMARK("Log/async/threads:16") {
+	bench::ThreadTeam team(logThreads);
+	logToNull sink;
+	AsyncLoggerConfig cfg;
+	cfg.overflowPolicy = AsyncLoggerConfig::Block;
+	AsyncLogger::start(cfg);
+	while (state.run()) {
+		team.run(logLines);
+		AsyncLogger::flush();
+	}
+	AsyncLogger::stop();
+	state.setItemsProcessed(state.iterations() * logThreads * linesPerThread);
+}
+
+// only the cost on the logging threads; lines that don't fit are dropped instead of waiting for the writer
+BENCHMARK("Log/async/threads:16/callerOnly") {
+	bench::ThreadTeam team(logThreads);
+	logToNull sink;
+	AsyncLogger::start();
+	while (state.run()) {
+		team.run(logLines);
+		state.pauseTiming();
+		AsyncLogger::flush();
+		state.resumeTiming();
+	}
+	AsyncLogger::stop();
+	state.setItemsProcessed(state.iterations() * logThreads * linesPerThread);
+}
+
+BENCHMARK("Log/async/threads:16/LOGF") {
+	bench::ThreadTeam team(logThreads);
+	logToNull sink;
+	AsyncLoggerConfig cfg;
+	cfg.overflowPolicy = AsyncLoggerConfig::Block;
+	AsyncLogger::start(cfg);
+	while (state.run()) {
+		team.run(logLinesDeferred);
+		AsyncLogger::flush();
+	}
+	AsyncLogger::stop();
+	state.setItemsProcessed(state.iterations() * logThreads * linesPerThread);
+}
+
+// the cost of one call on the logging thread; the writer runs outside of the measurement
+static void benchCallerCost(bench::State &state, void (*logFunc)(unsigned)) {
+	logToNull sink;
+	AsyncLogger::start();
+	while (state.run()) {
+		logFunc(0);
+		state.pauseTiming();
+		AsyncLogger::flush();
+		state.resumeTiming();
+	}
+	AsyncLogger::stop();
+	state.setItemsProcessed(state.iterations() * linesPerThread);
+}
+
+BENCHMARK("Log/async/call/LOGLN") {
+	benchCallerCost(state, logLines);
+}
+
+BENCHMARK("Log/async/call/LOGF") {
+	benchCallerCost(state, logLinesDeferred);
+}
+
+// a rate-limited call site that keeps firing; all but the first call are suppressed
+BENCHMARK("Log/LOGLN_EVERY_MS/suppressed") {
+	logToNull sink;
+	while (state.run())
+		LOGLN_EVERY_MS(60000, "capacity reached: " << state.iterations());
+}
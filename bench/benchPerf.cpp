@@ -0,0 +1,106 @@
+/*
+ * benchPerf.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ *
+ * Overhead of the perf instrumentation itself.
+ */
+
+#include "benchmark.h"
+
+#include <boglfw/perf/marker.h>
+#include <boglfw/perf/clock.h>
+#include <boglfw/perf/counters.h>
+#include <boglfw/perf/profiledMutex.h>
+
+#include <mutex>
+
+// turns the markers on for the duration of a benchmark
+class markersOn {
+public:
+	markersOn() { perf::setMarkersEnabled(true); }
+	~markersOn() { perf::setMarkersEnabled(false); }
+};
+
+// enables only the given marker categories for the duration of a benchmark, then restores the previous ones
+class markerCategories {
+public:
+	explicit markerCategories(unsigned mask) : previous_(perf::getEnabledMarkerCategories()) { perf::setEnabledMarkerCategories(mask); }
+	~markerCategories() { perf::setEnabledMarkerCategories(previous_); }
+private:
+	unsigned previous_;
+};
+
+BENCHMARK("perf/marker/disabled") {
+	while (state.run()) {
+		PERF_MARKER("bench-marker");
+	}
+	state.setItemsProcessed(state.iterations());
+}
+
+BENCHMARK("perf/marker/enabled") {
+	markersOn on;
+	while (state.run()) {
+		PERF_MARKER("bench-marker");
+	}
+	state.setItemsProcessed(state.iterations());
+}
+
+// the category is switched off while the rest stay on
+BENCHMARK("perf/marker/categoryDisabled") {
+	markersOn on;
+	markerCategories cats(perf::MarkerCategory::All & ~perf::MarkerCategory::User);
+	while (state.run()) {
+		PERF_MARKER_CAT(perf::MarkerCategory::User, "bench-marker");
+	}
+	state.setItemsProcessed(state.iterations());
+}
+
+BENCHMARK("perf/marker/frameCapture") {
+	markersOn on;
+	perf::FrameCapture::start(perf::FrameCapture::ThisThreadOnly);
+	while (state.run()) {
+		PERF_MARKER("bench-marker");
+	}
+	perf::FrameCapture::stop();
+	perf::FrameCapture::cleanup();
+	state.setItemsProcessed(state.iterations());
+}
+
+BENCHMARK("perf/Clock::now") {
+	while (state.run())
+		bench::doNotOptimize(perf::Clock::now());
+}
+
+BENCHMARK("perf/steady_clock::now") {
+	while (state.run())
+		bench::doNotOptimize(std::chrono::steady_clock::now());
+}
+
+BENCHMARK("perf/counter") {
+	while (state.run())
+		PERF_COUNTER("bench-counter", 1);
+}
+
+BENCHMARK("perf/ProfiledMutex/uncontended") {
+	perf::ProfiledMutex m("bench-mutex");
+	while (state.run()) {
+		std::lock_guard<perf::ProfiledMutex> lk(m);
+	}
+}
+
+BENCHMARK("perf/ProfiledMutex/uncontended/recording") {
+	markersOn on;
+	perf::ProfiledMutex m("bench-mutex");
+	while (state.run()) {
+		std::lock_guard<perf::ProfiledMutex> lk(m);
+	}
+}
+
+BENCHMARK("perf/std::mutex/uncontended") {
+	std::mutex m;
+	while (state.run()) {
+		std::lock_guard<std::mutex> lk(m);
+	}
+}
@@ -0,0 +1,137 @@
+/*
+ * benchRender.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ *
+ * The CPU side of the 2D render helpers (vertex and index building), using RenderHelpers' headless mode.
+ */
+
+#include "benchmark.h"
+
+#include <boglfw/renderOpenGL/RenderHelpers.h>
+#include <boglfw/renderOpenGL/Shape2D.h>
+#include <boglfw/renderOpenGL/GLText.h>
+#include <boglfw/utils/filesystem.h>
+#include <boglfw/math/constants.h>
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <cmath>
+
+// set by the build to the framework's data directory; otherwise data is looked up relative to the working directory
+#ifndef BOGLFW_BENCH_DATA_DIR
+#define BOGLFW_BENCH_DATA_DIR "data/"
+#endif
+
+static constexpr unsigned shapesPerFrame = 256;	// shapes drawn per iteration, before flushing
+
+// loads the render helpers in headless mode on first use; returns false if GLText couldn't be loaded
+static bool loadRenderHelpers() {
+	static bool hasText = [] {
+		RenderHelpers::Config cfg;
+		cfg.headless = true;
+		cfg.fontPath = std::string(BOGLFW_BENCH_DATA_DIR) + "fonts/DejaVuSans.desc";
+		cfg.disableGLText = !filesystem::pathExists(cfg.fontPath);
+		RenderHelpers::load(cfg);
+		return !cfg.disableGLText;
+	}();
+	return hasText;
+}
+
+BENCHMARK("Shape2D/drawLine") {
+	loadRenderHelpers();
+	auto &s = *Shape2D::get();
+	const glm::vec4 color(1, 0.5f, 0, 1);
+	while (state.run()) {
+		for (unsigned i=0; i<shapesPerFrame; i++)
+			s.drawLine({(float)i, 0}, {0, (float)i}, color);
+		s.flush();
+	}
+	state.setItemsProcessed(state.iterations() * shapesPerFrame);
+}
+
+BENCHMARK("Shape2D/drawRectangle") {
+	loadRenderHelpers();
+	auto &s = *Shape2D::get();
+	const glm::vec4 color(1, 0.5f, 0, 1);
+	while (state.run()) {
+		for (unsigned i=0; i<shapesPerFrame; i++)
+			s.drawRectangle({(float)i, (float)i}, {10, 5}, color);
+		s.flush();
+	}
+	state.setItemsProcessed(state.iterations() * shapesPerFrame);
+}
+
+BENCHMARK("Shape2D/drawCircle/sides:32") {
+	loadRenderHelpers();
+	auto &s = *Shape2D::get();
+	const glm::vec4 color(1, 0.5f, 0, 1);
+	while (state.run()) {
+		for (unsigned i=0; i<shapesPerFrame; i++)
+			s.drawCircle({(float)i, (float)i}, 10, 32, color);
+		s.flush();
+	}
+	state.setItemsProcessed(state.iterations() * shapesPerFrame);
+}
+
+BENCHMARK("Shape2D/drawCircleFilled/sides:32") {
+	loadRenderHelpers();
+	auto &s = *Shape2D::get();
+	const glm::vec4 color(1, 0.5f, 0, 1);
+	while (state.run()) {
+		for (unsigned i=0; i<shapesPerFrame; i++)
+			s.drawCircleFilled({(float)i, (float)i}, 10, 32, color);
+		s.flush();
+	}
+	state.setItemsProcessed(state.iterations() * shapesPerFrame);
+}
+
+// a concave star shape, so the triangulation has some work to do
+BENCHMARK("Shape2D/drawPolygonFilled/verts:16") {
+	loadRenderHelpers();
+	auto &s = *Shape2D::get();
+	const glm::vec4 color(1, 0.5f, 0, 1);
+	const int nVerts = 16;
+	glm::vec2 verts[nVerts];
+	for (int i=0; i<nVerts; i++) {
+		float r = i % 2 ? 5 : 10;
+		float angle = 2 * PI * i / nVerts;
+		verts[i] = glm::vec2(r * std::cos(angle), r * std::sin(angle));
+	}
+	while (state.run()) {
+		for (unsigned i=0; i<shapesPerFrame; i++)
+			s.drawPolygonFilled(verts, nVerts, color);
+		s.flush();
+	}
+	state.setItemsProcessed(state.iterations() * shapesPerFrame);
+}
+
+static const std::string benchText = "Entities: 1024   FPS: 60.0   frame time: 16.67 ms";
+
+BENCHMARK("GLText/print") {
+	if (!loadRenderHelpers()) {
+		state.skip("font not found in " BOGLFW_BENCH_DATA_DIR);
+		return;
+	}
+	auto &t = *GLText::get();
+	const glm::vec4 color(1, 1, 1, 1);
+	while (state.run()) {
+		for (unsigned i=0; i<shapesPerFrame; i++)
+			t.print(benchText, {10, (float)i}, 16, color);
+		t.flush();
+	}
+	state.setItemsProcessed(state.iterations() * shapesPerFrame * benchText.size());
+}
+
+BENCHMARK("GLText/getTextRect") {
+	if (!loadRenderHelpers()) {
+		state.skip("font not found in " BOGLFW_BENCH_DATA_DIR);
+		return;
+	}
+	auto &t = *GLText::get();
+	while (state.run())
+		bench::doNotOptimize(t.getTextRect(benchText, 16));
+	state.setItemsProcessed(state.iterations() * benchText.size());
+}
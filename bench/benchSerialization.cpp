@@ -0,0 +1,325 @@
+/*
+ * benchSerialization.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include "benchmark.h"
+
+#include <boglfw/serialization/BinaryStream.h>
+#include <boglfw/serialization/BigFile.h>
+#include <boglfw/serialization/BigFileWriter.h>
+#include <boglfw/utils/compression.h>
+#include <boglfw/utils/ThreadPool.h>
+
+#include <random>
+#include <cstdio>
+#include <memory>
+
+static constexpr unsigned recordsPerIteration = 1024;
+// one record is a uint32, a float and a uint64
+static constexpr unsigned recordSize = sizeof(uint32_t) + sizeof(float) + sizeof(uint64_t);
+
+static void writeRecords(BinaryStream &s) {
+	for (unsigned i=0; i<recordsPerIteration; i++)
+		s << (uint32_t)i << (float)i << (uint64_t)i;
+}
+
+BENCHMARK("BinaryStream/write") {
+	while (state.run()) {
+		// starts small so the buffer growth is part of the measurement, like when serializing a world of unknown size
+		BinaryStream s(256);
+		writeRecords(s);
+		bench::doNotOptimize(s.size());
+	}
+	state.setBytesProcessed(state.iterations() * recordsPerIteration * recordSize);
+}
+
+BENCHMARK("BinaryStream/read") {
+	BinaryStream src(recordsPerIteration * recordSize);
+	writeRecords(src);
+	std::vector<char> buffer((const char*)src.getBuffer(), (const char*)src.getBuffer() + src.size());
+	while (state.run()) {
+		BinaryStream s(buffer.data(), buffer.size());
+		uint32_t u32; float f; uint64_t u64;
+		uint64_t sum = 0;
+		for (unsigned i=0; i<recordsPerIteration; i++) {
+			s >> u32 >> f >> u64;
+			sum += u32 + u64;
+		}
+		bench::doNotOptimize(sum);
+	}
+	state.setBytesProcessed(state.iterations() * recordsPerIteration * recordSize);
+}
+
+BENCHMARK("BinaryStream/string") {
+	const std::string str = "data/textures/some-texture-name.png";
+	while (state.run()) {
+		BinaryStream s(256);
+		for (unsigned i=0; i<recordsPerIteration; i++)
+			s << str;
+		s.seek(0);
+		std::string in;
+		for (unsigned i=0; i<recordsPerIteration; i++)
+			s >> in;
+		bench::doNotOptimize(in);
+	}
+	state.setItemsProcessed(state.iterations() * recordsPerIteration);
+}
+
+static const char bigFileBenchPath[] = "boglfw-bench-bigfile.tmp";
+static constexpr unsigned bigFileEntries = 64;
+static constexpr unsigned bigFileEntrySize = 16 * 1024;
+
+// fills a BigFile with pseudo-random content (fixed seed, so it's the same on every run)
+static void fillBigFile(BigFile &bf, std::vector<std::vector<char>> &contents) {
+	std::mt19937 rng(1234);
+	contents.resize(bigFileEntries);
+	for (unsigned i=0; i<bigFileEntries; i++) {
+		contents[i].resize(bigFileEntrySize);
+		for (auto &c : contents[i])
+			c = (char)rng();
+		bf.addFile("file-" + std::to_string(i) + ".dat", contents[i].data(), contents[i].size());
+	}
+}
+
+// saves the archive to bigFileBenchPath; on failure skips the benchmark and returns false
+static bool saveBenchArchive(bench::State &state, BigFile &bf, BigFileSaveOptions const& options = {}) {
+	if (bf.saveToDisk(bigFileBenchPath, options))
+		return true;
+	state.skip(std::string("could not write ") + bigFileBenchPath);
+	return false;
+}
+
+// writes the fillBigFile() contents to bigFileBenchPath, for the benchmarks that read it back
+static bool writeBenchArchive(bench::State &state) {
+	BigFile bf;
+	std::vector<std::vector<char>> contents;
+	fillBigFile(bf, contents);
+	return saveBenchArchive(state, bf);
+}
+
+BENCHMARK("BigFile/save") {
+	BigFile bf;
+	std::vector<std::vector<char>> contents;
+	fillBigFile(bf, contents);
+	while (state.run()) {
+		if (!saveBenchArchive(state, bf))
+			return;
+	}
+	remove(bigFileBenchPath);
+	state.setBytesProcessed(state.iterations() * bigFileEntries * bigFileEntrySize);
+}
+
+// the same contents as BigFile/save, written as they're produced, without collecting them in a BigFile first
+BENCHMARK("BigFileWriter/write") {
+	BigFile bf;
+	std::vector<std::vector<char>> contents;
+	fillBigFile(bf, contents);
+	while (state.run()) {
+		BigFileWriter writer;
+		bool ok = writer.open(bigFileBenchPath);
+		for (unsigned i=0; i<bigFileEntries && ok; i++)
+			ok = writer.addFile("file-" + std::to_string(i) + ".dat", contents[i].data(), contents[i].size());
+		if (!ok || !writer.finish()) {
+			state.skip(std::string("could not write ") + bigFileBenchPath);
+			return;
+		}
+	}
+	remove(bigFileBenchPath);
+	state.setBytesProcessed(state.iterations() * bigFileEntries * bigFileEntrySize);
+}
+
+BENCHMARK("BigFile/load") {
+	if (!writeBenchArchive(state))
+		return;
+	while (state.run()) {
+		BigFile bf;
+		if (!bf.loadFromDisk(bigFileBenchPath)) {
+			state.skip(std::string("could not load ") + bigFileBenchPath);
+			return;
+		}
+		bench::doNotOptimize(bf.getFile("file-0.dat").pStart);
+	}
+	remove(bigFileBenchPath);
+	state.setBytesProcessed(state.iterations() * bigFileEntries * bigFileEntrySize);
+}
+
+// opening a mapped archive and reading a single entry, the common case for big save files
+BENCHMARK("BigFile/load/mapped/oneEntry") {
+	if (!writeBenchArchive(state))
+		return;
+	while (state.run()) {
+		BigFile bf;
+		if (!bf.loadFromDisk(bigFileBenchPath, BigFile::LoadMode::Mapped)) {
+			state.skip(std::string("could not map ") + bigFileBenchPath);
+			return;
+		}
+		auto fd = bf.getFile("file-0.dat");
+		uint64_t sum = 0;
+		for (size_t i=0; i<fd.size; i += sizeof(uint64_t))
+			sum += *(const uint64_t*)((const char*)fd.pStart + i);
+		bench::doNotOptimize(sum);
+	}
+	remove(bigFileBenchPath);
+	state.setBytesProcessed(state.iterations() * bigFileEntrySize);
+}
+
+// the same bulk read as BigFile/load, through the mapping
+BENCHMARK("BigFile/load/mapped/allEntries") {
+	if (!writeBenchArchive(state))
+		return;
+	while (state.run()) {
+		BigFile bf;
+		if (!bf.loadFromDisk(bigFileBenchPath, BigFile::LoadMode::Mapped)) {
+			state.skip(std::string("could not map ") + bigFileBenchPath);
+			return;
+		}
+		bf.prefetchAll();
+		uint64_t sum = 0;
+		for (auto &fd : bf.getAllFiles())
+			for (size_t i=0; i<fd.size; i += sizeof(uint64_t))
+				sum += *(const uint64_t*)((const char*)fd.pStart + i);
+		bench::doNotOptimize(sum);
+	}
+	remove(bigFileBenchPath);
+	state.setBytesProcessed(state.iterations() * bigFileEntries * bigFileEntrySize);
+}
+
+// opening a mapped archive with many small entries and looking one up: version 1 parses the whole table into a map,
+// version 2 uses the table and its hash index in place
+static void benchOpenManyEntries(bench::State &state, unsigned formatVersion) {
+	static constexpr unsigned numEntries = 16 * 1024;
+	do {
+		BigFile bf;
+		char contents[64] {};
+		for (unsigned i=0; i<numEntries; i++)
+			bf.addFile("chunk-" + std::to_string(i) + ".dat", contents, sizeof(contents));
+		BigFileSaveOptions options;
+		options.formatVersion = formatVersion;
+		if (!saveBenchArchive(state, bf, options))
+			return;
+	} while (0);
+	const std::string name = "chunk-" + std::to_string(numEntries / 2) + ".dat";
+	while (state.run()) {
+		BigFile bf;
+		if (!bf.loadFromDisk(bigFileBenchPath, BigFile::LoadMode::Mapped)) {
+			state.skip(std::string("could not map ") + bigFileBenchPath);
+			return;
+		}
+		bench::doNotOptimize(bf.getFile(name).pStart);
+	}
+	remove(bigFileBenchPath);
+}
+
+BENCHMARK("BigFile/open/mapped/v1/entries:16K") {
+	benchOpenManyEntries(state, 1);
+}
+
+BENCHMARK("BigFile/open/mapped/v2/entries:16K") {
+	benchOpenManyEntries(state, 2);
+}
+
+// something like a serialized world: entity records with ids, type names and slowly changing coordinates
+static std::vector<char> makeWorldData(size_t size, unsigned seed) {
+	static const char* const types[] { "Bug", "Food", "Wall", "Gamete", "Egg" };
+	std::mt19937 rng(seed);
+	BinaryStream s(size + 64);
+	float x = 0, y = 0;
+	for (uint32_t id = seed * 100000; s.size() < size; id++) {
+		x += (rng() % 100) * 0.01f;
+		y += (rng() % 100) * 0.01f;
+		s << id << std::string(types[rng() % 5]) << x << y << (float)(rng() % 360) << (uint32_t)(rng() % 4);
+	}
+	return std::vector<char>((const char*)s.getBuffer(), (const char*)s.getBuffer() + size);
+}
+
+static constexpr size_t compressionBlockSize = 256 * 1024;
+
+// compression and decompression speed and ratio, for each method available in this build
+static bench::registrar compressionMethods([] {
+	for (auto method : { CompressionMethod::FastLZ, CompressionMethod::LZ4, CompressionMethod::Zstd }) {
+		if (!Compression::isAvailable(method))
+			continue;
+		std::string name = std::string("Compression/") + Compression::getName(method);
+		bench::registerBenchmark(name + "/compress", [method] (bench::State &state) {
+			auto data = makeWorldData(compressionBlockSize, 1);
+			std::vector<char> out(Compression::maxCompressedSize(method, data.size()));
+			size_t size = 0;
+			while (state.run())
+				size = Compression::compress(method, data.data(), data.size(), out.data(), out.size());
+			state.setBytesProcessed(state.iterations() * data.size());
+			state.setCounter("ratio", size ? (double)data.size() / size : 0);
+		});
+		bench::registerBenchmark(name + "/decompress", [method] (bench::State &state) {
+			auto data = makeWorldData(compressionBlockSize, 1);
+			std::vector<char> compressed(Compression::maxCompressedSize(method, data.size()));
+			compressed.resize(Compression::compress(method, data.data(), data.size(), compressed.data(), compressed.size()));
+			std::vector<char> out(data.size());
+			while (state.run()) {
+				if (!Compression::decompress(method, compressed.data(), compressed.size(), out.data(), out.size())) {
+					state.skip("decompression failed");
+					return;
+				}
+			}
+			state.setBytesProcessed(state.iterations() * data.size());
+			state.setCounter("ratio", (double)data.size() / compressed.size());
+		});
+	}
+});
+
+static constexpr unsigned worldFileEntries = 64;
+
+// saving and loading a compressed BigFile, serially or on a thread pool; throughput is of the uncompressed data
+static void benchCompressedBigFile(bench::State &state, bool save, unsigned threads) {
+	BigFile bf;
+	for (unsigned i=0; i<worldFileEntries; i++) {
+		auto data = makeWorldData(compressionBlockSize, i);
+		bf.addFile("chunk-" + std::to_string(i) + ".dat", data.data(), data.size());
+	}
+	std::unique_ptr<ThreadPool> pool(threads ? new ThreadPool(threads) : nullptr);
+	// the pool must be stopped before it's destroyed, on every way out
+	struct poolStopper {
+		ThreadPool *pool;
+		~poolStopper() { if (pool) pool->stop(); }
+	} stopPool { pool.get() };
+	BigFileSaveOptions options;
+	options.compression = Compression::getPreferred();
+	options.threadPool = pool.get();
+	if (!saveBenchArchive(state, bf, options))
+		return;
+	while (state.run()) {
+		bool ok = true;
+		if (save)
+			ok = bf.saveToDisk(bigFileBenchPath, options);
+		else {
+			BigFile loaded;
+			ok = loaded.loadFromDisk(bigFileBenchPath, BigFile::LoadMode::Mapped, pool.get());
+		}
+		if (!ok) {
+			state.skip(std::string("could not access ") + bigFileBenchPath);
+			break;
+		}
+	}
+	if (FILE* f = fopen(bigFileBenchPath, "rb")) {
+		fseek(f, 0, SEEK_END);
+		state.setCounter("ratio", (double)worldFileEntries * compressionBlockSize / ftell(f));
+		fclose(f);
+	}
+	remove(bigFileBenchPath);
+	state.setBytesProcessed(state.iterations() * worldFileEntries * compressionBlockSize);
+}
+
+static bench::registrar compressedBigFile([] {
+	unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned threads : { 0u, hw }) {
+		std::string suffix = threads ? "/threads:" + std::to_string(threads) : "/serial";
+		bench::registerBenchmark("BigFile/save/compressed" + suffix, [threads] (bench::State &state) {
+			benchCompressedBigFile(state, true, threads);
+		});
+		bench::registerBenchmark("BigFile/load/compressed" + suffix, [threads] (bench::State &state) {
+			benchCompressedBigFile(state, false, threads);
+		});
+	}
+});
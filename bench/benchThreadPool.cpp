@@ -0,0 +1,54 @@
+/*
+ * benchThreadPool.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include "benchmark.h"
+
+#include <boglfw/utils/ThreadPool.h>
+#include <boglfw/utils/parallel.h>
+
+#include <cmath>
+
+static constexpr unsigned tasksPerBatch = 64;
+
+BENCHMARK("ThreadPool/queueTask+wait") {
+	ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+	std::vector<PoolTaskHandle> tasks;
+	tasks.reserve(tasksPerBatch);
+	while (state.run()) {
+		for (unsigned i=0; i<tasksPerBatch; i++)
+			tasks.push_back(pool.queueTask([] {}));
+		for (auto &t : tasks)
+			t->wait();
+		tasks.clear();
+	}
+	pool.stop();
+	state.setItemsProcessed(state.iterations() * tasksPerBatch);
+}
+
+// one iteration processes the whole range; compare the results between thread counts to see how it scales
+static bench::registrar parallelForScaling([] {
+	std::vector<unsigned> threadCounts { 1, 2, 4, 8 };
+	unsigned hw = std::thread::hardware_concurrency();
+	if (hw > 8)
+		threadCounts.push_back(hw);
+	for (unsigned threads : threadCounts) {
+		bench::registerBenchmark("ThreadPool/parallel_for/threads:" + std::to_string(threads), [threads] (bench::State &state) {
+			const unsigned n = 1 << 14;
+			std::vector<float> data(n, 1.f);
+			ThreadPool pool(threads);
+			while (state.run()) {
+				parallel_for(data.begin(), data.end(), pool, [] (float &x) {
+					// a few dozen ns of work per element
+					for (int k=0; k<8; k++)
+						x = std::sqrt(x * x + 1.f);
+				});
+			}
+			pool.stop();
+			state.setItemsProcessed(state.iterations() * n);
+		});
+	}
+});
@@ -0,0 +1,171 @@
+/*
+ * benchUtils.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ *
+ * MTVector and the lock-free queues, compared against their mutex-based equivalents.
+ */
+
+#include "benchmark.h"
+
+#include <boglfw/utils/MTVector.h>
+#include <boglfw/utils/SPSCQueue.h>
+#include <boglfw/utils/MPMCQueue.h>
+
+#include <queue>
+#include <mutex>
+#include <numeric>
+
+static constexpr unsigned itemsPerRound = 1024;		// items each thread transfers per iteration
+
+BENCHMARK("MTVector/push_back") {
+	MTVector<int> v(state.iterations());
+	while (state.run())
+		v.push_back(1);
+	state.setItemsProcessed(state.iterations());
+}
+
+BENCHMARK("MTVector/iterate") {
+	const unsigned n = 1 << 16;
+	MTVector<int> v(n);
+	for (unsigned i=0; i<n; i++)
+		v.push_back(i);
+	while (state.run()) {
+		int sum = std::accumulate(v.begin(), v.end(), 0);
+		bench::doNotOptimize(sum);
+	}
+	state.setItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK("std::vector+mutex/push_back") {
+	std::vector<int> v;
+	v.reserve(state.iterations());
+	std::mutex m;
+	while (state.run()) {
+		std::lock_guard<std::mutex> lk(m);
+		v.push_back(1);
+	}
+	state.setItemsProcessed(state.iterations());
+}
+
+static bench::registrar mtVectorThreads([] {
+	for (unsigned threads : {2, 4, 8}) {
+		bench::registerBenchmark("MTVector/push_back/threads:" + std::to_string(threads), [threads] (bench::State &state) {
+			bench::ThreadTeam team(threads);
+			MTVector<int> v(threads * itemsPerRound);
+			while (state.run()) {
+				team.run([&v] (unsigned) {
+					for (unsigned i=0; i<itemsPerRound; i++)
+						v.push_back(i);
+				});
+				state.pauseTiming();
+				v.clear();
+				state.resumeTiming();
+			}
+			state.setItemsProcessed(state.iterations() * threads * itemsPerRound);
+		});
+		bench::registerBenchmark("std::vector+mutex/push_back/threads:" + std::to_string(threads), [threads] (bench::State &state) {
+			bench::ThreadTeam team(threads);
+			std::vector<int> v;
+			v.reserve(threads * itemsPerRound);
+			std::mutex m;
+			while (state.run()) {
+				team.run([&v, &m] (unsigned) {
+					for (unsigned i=0; i<itemsPerRound; i++) {
+						std::lock_guard<std::mutex> lk(m);
+						v.push_back(i);
+					}
+				});
+				state.pauseTiming();
+				v.clear();
+				state.resumeTiming();
+			}
+			state.setItemsProcessed(state.iterations() * threads * itemsPerRound);
+		});
+	}
+});
+
+// the mutex-based queue the lock-free ones are compared against
+template<class C>
+class lockedQueue {
+public:
+	void push(C const& c) {
+		while (true) {
+			{
+				std::lock_guard<std::mutex> lk(mutex_);
+				if (queue_.size() < capacity_) {
+					queue_.push(c);
+					return;
+				}
+			}
+			std::this_thread::yield();
+		}
+	}
+	void pop(C &out) {
+		while (true) {
+			{
+				std::lock_guard<std::mutex> lk(mutex_);
+				if (!queue_.empty()) {
+					out = queue_.front();
+					queue_.pop();
+					return;
+				}
+			}
+			std::this_thread::yield();
+		}
+	}
+	explicit lockedQueue(size_t capacity) : capacity_(capacity) {}
+private:
+	std::mutex mutex_;
+	std::queue<C> queue_;
+	size_t capacity_;
+};
+
+// producers push itemsPerRound items each and consumers pop the same total amount
+template<class Q>
+static void queueTransfer(bench::State &state, unsigned producers, unsigned consumers) {
+	bench::ThreadTeam team(producers + consumers);
+	Q queue(256);
+	const unsigned itemsPerConsumer = producers * itemsPerRound / consumers;
+	while (state.run()) {
+		team.run([&] (unsigned index) {
+			if (index < producers) {
+				for (unsigned i=0; i<itemsPerRound; i++)
+					queue.push(i);
+			} else {
+				uint64_t sum = 0, value;
+				for (unsigned i=0; i<itemsPerConsumer; i++) {
+					queue.pop(value);
+					sum += value;
+				}
+				bench::doNotOptimize(sum);
+			}
+		});
+	}
+	state.setItemsProcessed(state.iterations() * producers * itemsPerRound);
+}
+
+BENCHMARK("Queue/SPSCQueue/1p1c") {
+	queueTransfer<SPSCQueue<uint64_t>>(state, 1, 1);
+}
+
+BENCHMARK("Queue/mutex/1p1c") {
+	queueTransfer<lockedQueue<uint64_t>>(state, 1, 1);
+}
+
+BENCHMARK("Queue/MPMCQueue/2p2c") {
+	queueTransfer<MPMCQueue<uint64_t>>(state, 2, 2);
+}
+
+BENCHMARK("Queue/mutex/2p2c") {
+	queueTransfer<lockedQueue<uint64_t>>(state, 2, 2);
+}
+
+BENCHMARK("Queue/MPMCQueue/4p4c") {
+	queueTransfer<MPMCQueue<uint64_t>>(state, 4, 4);
+}
+
+BENCHMARK("Queue/mutex/4p4c") {
+	queueTransfer<lockedQueue<uint64_t>>(state, 4, 4);
+}
@@ -0,0 +1,67 @@
+/*
+ * benchWorld.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include "benchmark.h"
+
+#include <boglfw/World.h>
+#include <boglfw/entities/Entity.h>
+
+#include <memory>
+
+// an updatable entity doing a small amount of work, roughly like a simple moving object
+class benchEntity : public Entity {
+public:
+	FunctionalityFlags getFunctionalityFlags() const override { return FunctionalityFlags::UPDATABLE; }
+	unsigned getEntityType() const override { return 0; }
+	void update(float dt) override {
+		velocity_ += glm::vec3(0, -9.8f, 0) * dt;
+		transform_.moveWorld(velocity_ * dt);
+	}
+private:
+	glm::vec3 velocity_ {1, 0, 0};
+};
+
+static bench::registrar worldUpdate([] {
+	for (unsigned entities : {1000, 10000}) {
+		bench::registerBenchmark("World/update/entities:" + std::to_string(entities), [entities] (bench::State &state) {
+			auto &world = World::getInstance();
+			for (unsigned i=0; i<entities; i++)
+				world.takeOwnershipOf(std::make_shared<benchEntity>());
+			world.update(0);	// takes over the new entities
+			while (state.run())
+				world.update(0.016f);
+			world.reset();
+			state.setItemsProcessed(state.iterations() * entities);
+		});
+	}
+});
+
+// each iteration creates and destroys a batch of entities on top of a stable population
+BENCHMARK("World/churn") {
+	const unsigned population = 1000;
+	const unsigned batch = 100;
+	auto &world = World::getInstance();
+	for (unsigned i=0; i<population; i++)
+		world.takeOwnershipOf(std::make_shared<benchEntity>());
+	world.update(0);
+	std::vector<Entity*> created;
+	created.reserve(batch);
+	while (state.run()) {
+		for (unsigned i=0; i<batch; i++) {
+			auto e = std::make_shared<benchEntity>();
+			created.push_back(e.get());
+			world.takeOwnershipOf(e);
+		}
+		world.update(0.016f);
+		for (auto e : created)
+			e->destroy();
+		created.clear();
+		world.update(0.016f);
+	}
+	world.reset();
+	state.setItemsProcessed(state.iterations() * batch);
+}
@@ -0,0 +1,239 @@
+/*
+ * benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include "benchmark.h"
+
+#include <boglfw/perf/clock.h>
+
+#include <map>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <ctime>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+
+namespace bench {
+
+// function-local so that registration from other translation units' static initializers is safe
+static std::map<std::string, BenchFunc>& getRegistry() {
+	static std::map<std::string, BenchFunc> registry;
+	return registry;
+}
+
+void registerBenchmark(std::string const& name, BenchFunc func) {
+	getRegistry()[name] = func;
+}
+
+std::vector<std::string> getBenchmarkNames(std::string const& filter) {
+	std::vector<std::string> ret;
+	for (auto &p : getRegistry())
+		if (p.first.find(filter) != std::string::npos)
+			ret.push_back(p.first);
+	return ret;
+}
+
+// runs one sample; returns false if the benchmark skipped itself
+static bool runSample(BenchFunc const& func, uint64_t iterations, State &outState) {
+	outState = State(iterations);
+	func(outState);
+	if (outState.isSkipped())
+		return false;
+	if (!outState.isComplete()) {
+		outState.skip("benchmark body didn't loop until State::run() returned false");
+		return false;
+	}
+	return true;
+}
+
+static Result runBenchmark(std::string const& name, BenchFunc const& func, RunConfig const& config) {
+	Result result;
+	result.name = name;
+	State state(1);
+	// find the number of iterations for one sample to take at least minSampleMillisec; this also warms up caches etc.
+	uint64_t iterations = 1;
+	const double minSampleNanosec = config.minSampleMillisec * 1e6;
+	while (true) {
+		if (!runSample(func, iterations, state)) {
+			result.skipped = true;
+			result.skipReason = state.getSkipReason();
+			return result;
+		}
+		double elapsed = std::max<double>(state.getElapsedNanosec(), 1);
+		if (elapsed >= minSampleNanosec)
+			break;
+		// aim slightly above the target, but don't grow by more than 100x at a time in case the first runs were cold
+		double factor = std::min(100.0, minSampleNanosec * 1.2 / elapsed);
+		iterations = std::max<uint64_t>(iterations + 1, iterations * factor);
+	}
+	result.iterations = iterations;
+
+	uint64_t totalItems = 0, totalBytes = 0, totalNanosec = 0;
+	for (unsigned i=0; i<config.samples; i++) {
+		if (!runSample(func, iterations, state)) {
+			result.skipped = true;
+			result.skipReason = state.getSkipReason();
+			return result;
+		}
+		result.samples.push_back((double)state.getElapsedNanosec() / iterations);
+		totalItems += state.getItemsProcessed();
+		totalBytes += state.getBytesProcessed();
+		totalNanosec += state.getElapsedNanosec();
+	}
+
+	auto sorted = result.samples;
+	std::sort(sorted.begin(), sorted.end());
+	auto n = sorted.size();
+	result.medianNanosec = n % 2 ? sorted[n/2] : (sorted[n/2-1] + sorted[n/2]) / 2;
+	result.minNanosec = sorted.front();
+	result.maxNanosec = sorted.back();
+	result.meanNanosec = std::accumulate(sorted.begin(), sorted.end(), 0.0) / n;
+	double sumSq = 0;
+	for (auto s : sorted)
+		sumSq += (s - result.meanNanosec) * (s - result.meanNanosec);
+	result.stdDevNanosec = n > 1 ? std::sqrt(sumSq / (n - 1)) : 0;
+	result.counters = state.getCounters();
+	if (totalNanosec) {
+		result.itemsPerSecond = totalItems * 1e9 / totalNanosec;
+		result.bytesPerSecond = totalBytes * 1e9 / totalNanosec;
+	}
+	return result;
+}
+
+std::vector<Result> runBenchmarks(RunConfig const& config) {
+	std::vector<Result> results;
+	auto &registry = getRegistry();
+	for (auto &name : getBenchmarkNames(config.filter)) {
+		std::cerr << name << " ... " << std::flush;
+		results.push_back(runBenchmark(name, registry[name], config));
+		auto &r = results.back();
+		if (r.skipped)
+			std::cerr << "skipped (" << r.skipReason << ")\n";
+		else {
+			std::cerr << std::fixed << std::setprecision(2) << r.medianNanosec << " ns/iter (+/- "
+				<< r.stdDevNanosec << ")" << std::defaultfloat;
+			for (auto &c : r.counters)
+				std::cerr << " " << c.first << "=" << c.second;
+			std::cerr << "\n";
+		}
+	}
+	return results;
+}
+
+static std::string escapeJson(std::string const& str) {
+	std::string ret;
+	for (char c : str) {
+		switch (c) {
+		case '"': ret += "\\\""; break;
+		case '\\': ret += "\\\\"; break;
+		case '\n': ret += "\\n"; break;
+		case '\t': ret += "\\t"; break;
+		default:
+			if ((unsigned char)c < 0x20) {
+				char buf[8];
+				snprintf(buf, sizeof(buf), "\\u%04x", c);
+				ret += buf;
+			} else
+				ret += c;
+		}
+	}
+	return ret;
+}
+
+void writeJson(std::ostream &out, RunConfig const& config, std::vector<Result> const& results) {
+	char timeStr[32];
+	time_t now = time(nullptr);
+	strftime(timeStr, sizeof(timeStr), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+	out << std::setprecision(6);
+	out << "{\n";
+	out << "  \"context\": {\n";
+	out << "    \"date\": \"" << timeStr << "\",\n";
+	out << "    \"hardwareConcurrency\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef __VERSION__
+	out << "    \"compiler\": \"" << escapeJson(__VERSION__) << "\",\n";
+#endif
+#ifdef NDEBUG
+	out << "    \"buildType\": \"release\",\n";
+#elif defined(DEBUG)
+	out << "    \"buildType\": \"debug\",\n";
+#else
+	out << "    \"buildType\": \"default\",\n";
+#endif
+	out << "    \"perfClockUsesTsc\": " << (perf::Clock::isUsingTsc() ? "true" : "false") << ",\n";
+	out << "    \"samples\": " << config.samples << ",\n";
+	out << "    \"minSampleMillisec\": " << config.minSampleMillisec << "\n";
+	out << "  },\n";
+	out << "  \"benchmarks\": [";
+	for (unsigned i=0; i<results.size(); i++) {
+		auto &r = results[i];
+		out << (i ? ",\n" : "\n") << "    {\"name\": \"" << escapeJson(r.name) << "\"";
+		if (r.skipped) {
+			out << ", \"skipped\": true, \"reason\": \"" << escapeJson(r.skipReason) << "\"}";
+			continue;
+		}
+		out << ", \"iterations\": " << r.iterations
+			<< ", \"medianNs\": " << r.medianNanosec
+			<< ", \"meanNs\": " << r.meanNanosec
+			<< ", \"minNs\": " << r.minNanosec
+			<< ", \"maxNs\": " << r.maxNanosec
+			<< ", \"stdDevNs\": " << r.stdDevNanosec;
+		if (r.itemsPerSecond)
+			out << ", \"itemsPerSecond\": " << r.itemsPerSecond;
+		if (r.bytesPerSecond)
+			out << ", \"bytesPerSecond\": " << r.bytesPerSecond;
+		if (!r.counters.empty()) {
+			out << ", \"counters\": {";
+			for (auto it = r.counters.begin(); it != r.counters.end(); ++it)
+				out << (it == r.counters.begin() ? "" : ", ") << "\"" << escapeJson(it->first) << "\": " << it->second;
+			out << "}";
+		}
+		out << ", \"samplesNs\": [";
+		for (unsigned s=0; s<r.samples.size(); s++)
+			out << (s ? ", " : "") << r.samples[s];
+		out << "]}";
+	}
+	out << "\n  ]\n}\n";
+}
+
+ThreadTeam::ThreadTeam(unsigned threadCount) {
+	for (unsigned i=0; i<threadCount; i++)
+		threads_.emplace_back(&ThreadTeam::threadFunc, this, i);
+}
+
+ThreadTeam::~ThreadTeam() {
+	stop_.store(true, std::memory_order_release);
+	for (auto &t : threads_)
+		t.join();
+}
+
+void ThreadTeam::run(std::function<void(unsigned threadIndex)> func) {
+	func_ = func;
+	pending_.store(threads_.size(), std::memory_order_relaxed);
+	generation_.fetch_add(1, std::memory_order_release);
+	while (pending_.load(std::memory_order_acquire))
+		std::this_thread::yield();
+}
+
+void ThreadTeam::threadFunc(unsigned index) {
+	unsigned seenGeneration = 0;
+	while (true) {
+		unsigned gen;
+		// yield instead of spinning hard, so oversubscribed benchmarks still make progress
+		while ((gen = generation_.load(std::memory_order_acquire)) == seenGeneration) {
+			if (stop_.load(std::memory_order_acquire))
+				return;
+			std::this_thread::yield();
+		}
+		seenGeneration = gen;
+		func_(index);
+		pending_.fetch_sub(1, std::memory_order_acq_rel);
+	}
+}
+
+} // namespace bench
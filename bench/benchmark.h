@@ -0,0 +1,166 @@
+/*
+ * benchmark.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef BENCH_BENCHMARK_H_
+#define BENCH_BENCHMARK_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <cstdint>
+
+/*
+ * Defines and registers a benchmark at static initialization time:
+ *
+ *	BENCHMARK("MTVector/push_back") {
+ *		MTVector<int> v(state.iterations());	// setup is not timed
+ *		while (state.run())
+ *			v.push_back(1);
+ *		state.setItemsProcessed(state.iterations());
+ *	}
+ *
+ * The body runs once per sample with a fixed iteration count, determined beforehand so that one sample takes
+ * at least RunConfig::minSampleMillisec. Use '/' in names to group related cases ("ThreadPool/parallel_for/threads:4").
+ */
+#define BENCHMARK_COMBINE1(X,Y) X##Y
+#define BENCHMARK_COMBINE(X,Y) BENCHMARK_COMBINE1(X,Y)
+#define BENCHMARK(NAME) \
+	static void BENCHMARK_COMBINE(benchFunc,__LINE__)(bench::State &state); \
+	static bench::registrar BENCHMARK_COMBINE(benchRegistrar,__LINE__)(NAME, BENCHMARK_COMBINE(benchFunc,__LINE__)); \
+	static void BENCHMARK_COMBINE(benchFunc,__LINE__)(bench::State &state)
+
+namespace bench {
+
+class State {
+public:
+	using clock = std::chrono::steady_clock;
+
+	explicit State(uint64_t iterations) : iterations_(iterations) {}
+
+	// the benchmark body must loop while this returns true; the measurement starts with the first call
+	// and ends with the call that returns false
+	bool run() {
+		if (crtIteration_ < iterations_) {
+			if (crtIteration_++ == 0)
+				start_ = clock::now();
+			return true;
+		}
+		if (crtIteration_++ == iterations_)
+			end_ = clock::now();
+		return false;
+	}
+
+	uint64_t iterations() const { return iterations_; }
+
+	// exclude work done inside the loop (such as resetting a container) from the measurement
+	void pauseTiming() { pauseStart_ = clock::now(); }
+	void resumeTiming() { pausedNanosec_ += std::chrono::nanoseconds(clock::now() - pauseStart_).count(); }
+
+	// total amounts processed during the sample, used to report throughput
+	void setItemsProcessed(uint64_t items) { items_ = items; }
+	void setBytesProcessed(uint64_t bytes) { bytes_ = bytes; }
+	// other values to report as they are, such as a compression ratio; the last sample's values are kept
+	void setCounter(std::string const& name, double value) { counters_[name] = value; }
+
+	// call this instead of running the loop if the benchmark can't run (missing data file etc.)
+	void skip(std::string const& reason) { skipReason_ = reason; }
+
+	uint64_t getElapsedNanosec() const {
+		return std::chrono::nanoseconds(end_ - start_).count() - pausedNanosec_;
+	}
+	uint64_t getItemsProcessed() const { return items_; }
+	uint64_t getBytesProcessed() const { return bytes_; }
+	std::map<std::string, double> const& getCounters() const { return counters_; }
+	bool isSkipped() const { return !skipReason_.empty(); }
+	std::string const& getSkipReason() const { return skipReason_; }
+	bool isComplete() const { return crtIteration_ > iterations_; }
+
+private:
+	uint64_t iterations_;
+	uint64_t crtIteration_ = 0;
+	clock::time_point start_;
+	clock::time_point end_;
+	clock::time_point pauseStart_;
+	uint64_t pausedNanosec_ = 0;
+	uint64_t items_ = 0;
+	uint64_t bytes_ = 0;
+	std::map<std::string, double> counters_;
+	std::string skipReason_;
+};
+
+using BenchFunc = std::function<void(State&)>;
+
+void registerBenchmark(std::string const& name, BenchFunc func);
+
+struct registrar {
+	registrar(const char name[], BenchFunc func) { registerBenchmark(name, func); }
+	// for registering parameterized variants from a function
+	explicit registrar(std::function<void()> registerFunc) { registerFunc(); }
+};
+
+struct RunConfig {
+	std::string filter;				// only run the benchmarks whose name contains this
+	unsigned samples = 10;			// number of timed samples per benchmark
+	double minSampleMillisec = 20;	// the iteration count is chosen so that each sample takes at least this long
+};
+
+struct Result {
+	std::string name;
+	bool skipped = false;
+	std::string skipReason;
+	uint64_t iterations = 0;			// per sample
+	std::vector<double> samples;		// nanoseconds per iteration
+	double medianNanosec = 0;			// per iteration
+	double meanNanosec = 0;
+	double minNanosec = 0;
+	double maxNanosec = 0;
+	double stdDevNanosec = 0;
+	double itemsPerSecond = 0;			// 0 if the benchmark doesn't report items
+	double bytesPerSecond = 0;
+	std::map<std::string, double> counters;
+};
+
+std::vector<std::string> getBenchmarkNames(std::string const& filter);
+// runs the matching benchmarks in alphabetical order; progress is written to std::cerr
+std::vector<Result> runBenchmarks(RunConfig const& config);
+void writeJson(std::ostream &out, RunConfig const& config, std::vector<Result> const& results);
+
+// keeps the compiler from optimizing away a value that is computed but not used
+template<class T>
+inline void doNotOptimize(T const& value) {
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// a group of threads that execute the same function together and can be reused between iterations;
+// use this for measuring multi-threaded work without including the thread creation time
+class ThreadTeam {
+public:
+	explicit ThreadTeam(unsigned threadCount);
+	~ThreadTeam();
+
+	unsigned size() const { return threads_.size(); }
+	// runs func(threadIndex) on all threads and waits for all of them to finish
+	void run(std::function<void(unsigned threadIndex)> func);
+
+private:
+	std::vector<std::thread> threads_;
+	std::function<void(unsigned)> func_;
+	std::atomic<unsigned> generation_ {0};
+	std::atomic<unsigned> pending_ {0};
+	std::atomic<bool> stop_ {false};
+
+	void threadFunc(unsigned index);
+};
+
+} // namespace bench
+
+#endif /* BENCH_BENCHMARK_H_ */
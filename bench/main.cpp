@@ -0,0 +1,74 @@
+/*
+ * main.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ *
+ * boglfw-bench - micro-benchmarks for the framework's core primitives.
+ * Runs headless (no window or GL context is created) and writes the results as JSON.
+ *
+ * usage: boglfw-bench [--filter <substring>] [--samples <n>] [--min-time <millisec>] [--out <file.json>] [--list]
+ */
+
+#include "benchmark.h"
+
+#include <boglfw/utils/log.h>
+#include <boglfw/perf/marker.h>
+#include <boglfw/Infrastructure.h>
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+int main(int argc, char* argv[]) {
+	bench::RunConfig config;
+	std::string outPath;
+	bool listOnly = false;
+	for (int i=1; i<argc; i++) {
+		bool hasValue = i+1 < argc;
+		if (!strcmp(argv[i], "--filter") && hasValue)
+			config.filter = argv[++i];
+		else if (!strcmp(argv[i], "--samples") && hasValue)
+			config.samples = std::max(1, atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--min-time") && hasValue)
+			config.minSampleMillisec = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--out") && hasValue)
+			outPath = argv[++i];
+		else if (!strcmp(argv[i], "--list"))
+			listOnly = true;
+		else {
+			std::cerr << "usage: " << argv[0]
+				<< " [--filter <substring>] [--samples <n>] [--min-time <millisec>] [--out <file.json>] [--list]\n";
+			return 1;
+		}
+	}
+
+	if (listOnly) {
+		for (auto &name : bench::getBenchmarkNames(config.filter))
+			std::cout << name << "\n";
+		return 0;
+	}
+
+	// the framework's log output would interfere with the measurements (and with the JSON on stdout)
+	logger::setLogStream(nullptr);
+	// benchmarks that measure the markers turn them on themselves
+	perf::setMarkersEnabled(false);
+
+	auto results = bench::runBenchmarks(config);
+
+	if (outPath.empty())
+		bench::writeJson(std::cout, config, results);
+	else {
+		std::ofstream f(outPath);
+		if (!f.is_open()) {
+			std::cerr << "Could not open " << outPath << " for writing\n";
+			return 1;
+		}
+		bench::writeJson(f, config, results);
+	}
+
+	Infrastructure::shutDown();
+	return 0;
+}
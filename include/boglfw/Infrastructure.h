@@ -10,13 +10,28 @@
 
 #include "utils/ThreadPool.h"
 
+#include <vector>
+#include <memory>
+
+struct InfrastructureConfig {
+	ThreadPoolAffinity threadPoolAffinity;	// where the workers of the main thread pool are allowed to run
+	bool poolPerPackage = false;			// create an additional thread pool for each CPU package (socket), restricted to its CPUs
+};
+
 class Infrastructure {
 public:
-	// call this before exiting in order to stop the thread pool and free resources
-	static void shutDown() { getInst(true); }
+	// call this before the first use of Infrastructure
+	static void setConfig(InfrastructureConfig cfg);
+
+	// call this before exiting in order to stop the thread pool and free resources (also stops the AsyncLogger)
+	static void shutDown();
 
 	static ThreadPool& getThreadPool() { return getInst(false).threadPool_; }
 
+	// per-package thread pools; only available if InfrastructureConfig::poolPerPackage was set
+	static unsigned getPackageThreadPoolCount() { return getInst(false).packagePools_.size(); }
+	static ThreadPool& getPackageThreadPool(unsigned index) { return *getInst(false).packagePools_[index]; }
+
 private:
 	Infrastructure();
 	static Infrastructure& getInst(bool shuttingDown) {
@@ -35,6 +50,7 @@ private:
 	void shutDown_();
 
 	ThreadPool threadPool_;
+	std::vector<std::unique_ptr<ThreadPool>> packagePools_;
 };
 
 
@@ -56,6 +56,9 @@ public:
 		addSignal(name, [c]() { return c(); }, rgb, sampleInterval, maxSamples, minUpperY, maxLowerY, displayPrecision);
 	}
 
+	// plots the per-frame value of a perf counter or gauge (see perf/counters.h)
+	void addPerfCounter(std::string const& counterName, glm::vec3 const& rgb, float sampleInterval, int maxSamples = 50, float minUpperY = -1e20f, float maxLowerY = 1e20f, int displayPrecision = -1);
+
 	void update(float dt);
 	void draw(RenderContext const& ctx);
 
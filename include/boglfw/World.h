@@ -13,6 +13,7 @@
 #include "input/operations/IOperationSpatialLocator.h"
 #include "utils/MTVector.h"
 #include "utils/Event.h"
+#include "utils/ThreadPool.h"
 
 #ifdef WITH_BOX2D
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
@@ -37,6 +38,8 @@ struct WorldConfig {
 	bool disableParallelProcessing = false;	// set to true to disable parallel (multi-threaded) update of entities
 	bool disableUserEvents = false;			// set to true to disable propagation of user events
 	bool drawBoundaries = true;				// draw world boundaries
+	bool pipelinedUpdate = false;			// set to true to run each update on the thread pool concurrently with drawing the previous frame;
+											// entities are drawn from the state they captured in Entity::captureDrawState() (one frame latency)
 	float extent_Xn = -10;
 	float extent_Xp = 10;
 	float extent_Yn = -10;
@@ -101,7 +104,11 @@ public:
 #endif // WITH_BOX2D
 
 	// call update() on all UPDATABLE entities.
+	// in pipelined mode this first waits for the previous update to finish, then starts the new one in the background and returns.
 	void update(float dt);
+	// in pipelined mode, blocks until the update started by the last update() call has finished; does nothing otherwise.
+	// call this before accessing the entities from outside update() and draw().
+	void waitPendingUpdate();
 	// this will call draw() on *all* DRAWABLE entities; it's a naive render implementation when you don't need anything more complex.
 	void draw(RenderContext const& ctx);
 
@@ -150,12 +157,16 @@ protected:
 	decltype(deferredActions_) pendingActions_;
 	std::atomic<bool> executingDeferredActions_ { false };
 
+	// tasks of the update running in the background in pipelined mode
+	std::vector<PoolTaskHandle> pendingUpdateTasks_;
+
 	std::unordered_map<std::string, Event<void(int param)>> mapUserEvents_;
 
 	std::unordered_map<std::type_index, void*> userGlobals_;
 
 	void destroyPending();
 	void takeOverPending();
+	void executeDeferredActions();
 
 #ifdef WITH_BOX2D
 	void getFixtures(std::vector<b2Fixture*> &out, b2AABB const& AABB);
@@ -25,7 +25,7 @@ public:
 	explicit CameraController(Camera* target);
 	virtual ~CameraController();
 
-	void setTargetCamera(Camera* target) { camera_ = target; update(0); }
+	void setTargetCamera(Camera* target) { camera_ = target; applyToCamera(); }
 
 	unsigned getEntityType() const override { return EntityTypes::CAMERA_CTRL; }
 	// these flags MUST NOT change during the life time of the object, or else UNDEFINED BEHAVIOUR
@@ -76,6 +76,9 @@ private:
 	PathLerper<CameraNode> pathLerper_;
 	std::weak_ptr<Entity> attachedEntity_;
 	glm::vec3 attachOffset_;
+
+	// moves the camera to the current path position or attached entity; must only be called while no update is running
+	void applyToCamera();
 };
 
 #endif /* ENTITIES_CAMERACONTROLLER_H_ */
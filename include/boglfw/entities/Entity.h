@@ -45,6 +45,13 @@ public:
 	virtual Transform& getTransform() { return transform_; }
 	virtual const Transform& getTransform() const { return transform_; }
 
+	// called by World in pipelined mode (see WorldConfig::pipelinedUpdate) while no update is running, right before
+	// the next update starts; draw() will then run concurrently with that update, so it must only use state captured here.
+	// the default implementation captures getTransform(); when overriding, call the base implementation too.
+	virtual void captureDrawState() { drawTransform_ = getTransform(); hasDrawState_ = true; }
+	// the transform to use in draw(): the captured one in pipelined mode, or the current one otherwise
+	const Transform& getDrawTransform() const { return hasDrawState_ ? drawTransform_ : getTransform(); }
+
 	// return the AABB that contains this entity
 	// the default implementation returns a 1mx1mx1m AABB centered around the entitiy's transform origin
 	virtual AABB getAABB() const;
@@ -56,6 +63,8 @@ protected:
 	Entity() = default;
 
 	Transform transform_;
+	Transform drawTransform_;
+	bool hasDrawState_ = false;
 
 private:
 	std::atomic<bool> markedForDeletion_ {false};
@@ -0,0 +1,72 @@
+/*
+ * allocTracker.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef PERF_ALLOCTRACKER_H_
+#define PERF_ALLOCTRACKER_H_
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace perf {
+
+// allocations made by one thread while a section was the innermost active one.
+// written only by the owner thread, read by the reports
+struct allocStats {
+	std::atomic<uint64_t> count { 0 };
+	std::atomic<uint64_t> bytes { 0 };
+
+	void add(size_t size) {
+		count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		bytes.store(bytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+	}
+};
+
+/*
+ * Heap allocation tracking, compiled in only when the library is built with PERF_TRACK_ALLOCATIONS.
+ * Global malloc/calloc/realloc (glibc) or operator new (elsewhere) are hooked, and each allocation is attributed to the
+ * innermost perf section active on the allocating thread. Allocations made outside of any section are reported under
+ * "{no section}" (only for threads which have executed at least one marker).
+ * Frees are not tracked.
+ */
+class AllocationTracker {
+public:
+	struct SectionAllocations {
+		unsigned sectionId;
+		std::string name;
+		uint64_t count;
+		uint64_t bytes;
+	};
+
+	// returns true if the library was built with allocation tracking
+	static bool isEnabled();
+
+	// call this once per frame (from the main loop) to compute the allocations made during the last frame
+	static void frameBoundary();
+	// returns the sections that allocated most often during the last frame, most frequent first
+	static std::vector<SectionAllocations> getTopAllocators(unsigned maxCount);
+	// same, but since startup
+	static std::vector<SectionAllocations> getTotalAllocations(unsigned maxCount);
+
+	// called by the hooks
+	static void record(size_t size) {
+		if (crtTarget_)
+			crtTarget_->add(size);
+	}
+
+private:
+	friend class CallGraph;
+	static thread_local allocStats* crtTarget_;
+	static std::vector<SectionAllocations> lastFrame_;
+	static std::vector<SectionAllocations> totals_;
+};
+
+} /* namespace perf */
+
+#endif /* PERF_ALLOCTRACKER_H_ */
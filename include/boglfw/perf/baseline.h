@@ -0,0 +1,89 @@
+/*
+ * baseline.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef PERF_BASELINE_H_
+#define PERF_BASELINE_H_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace perf {
+
+struct BaselineSection {
+	std::string path;			// section name for flat entries, names along the call path joined by " > " for call tree entries
+	uint64_t executionCount = 0;
+	uint64_t inclusiveNanosec = 0;
+	uint64_t exclusiveNanosec = 0;
+	uint64_t p50 = 0, p90 = 0, p99 = 0, max = 0;
+	uint64_t stdDevNanosec = 0;	// of the individual executions' inclusive time
+
+	double getMeanNanosec() const { return executionCount ? (double)inclusiveNanosec / executionCount : 0; }
+};
+
+struct BaselineThread {
+	std::string name;	// threads sharing a name are merged together
+	std::vector<BaselineSection> flat;
+	std::vector<BaselineSection> tree;
+};
+
+/*
+ * A snapshot of perf::Results that can be saved to disk and compared against a later run (see diffBaselines()).
+ */
+struct Baseline {
+	std::vector<BaselineThread> threads;
+
+	// builds a baseline from the current perf::Results
+	static Baseline capture();
+
+	// returns false if the file could not be written
+	bool save(std::string const& path) const;
+	// returns false if the file is missing, corrupted or of an unknown version
+	static bool load(std::string const& path, Baseline &out);
+};
+
+enum class BaselineDiffRanking {
+	AbsoluteChange,		// of the mean execution time, largest regressions first
+	RelativeChange,		// of the mean execution time, largest regressions first; new sections rank above everything
+};
+
+struct BaselineDiffOptions {
+	// a section is flagged as regressed only if all of these are exceeded:
+	double minTScore = 3.0;				// Welch's t statistic of the mean execution time
+	double minRelativeChange = 0.05;	// relative change of the mean execution time
+	double minAbsoluteNanosec = 1000;	// absolute change of the mean execution time
+	// also compare the call tree entries, not only the flat lists
+	bool includeTree = false;
+	// the order of the result
+	BaselineDiffRanking ranking = BaselineDiffRanking::AbsoluteChange;
+};
+
+struct BaselineSectionDiff {
+	std::string thread;
+	std::string path;
+	bool fromTree = false;
+	bool onlyInBase = false;
+	bool onlyInCurrent = false;
+	BaselineSection base;
+	BaselineSection current;
+	double absoluteChangeNanosec = 0;	// of the mean execution time; positive means slower
+	double relativeChange = 0;			// absoluteChangeNanosec / base mean (+inf for new sections, -1 for removed ones)
+	double tScore = 0;					// positive means slower
+	bool regression = false;			// significantly slower
+	bool improvement = false;			// significantly faster
+};
+
+// compares two baselines section by section (matched by thread name and path);
+// the result is ordered according to options.ranking.
+std::vector<BaselineSectionDiff> diffBaselines(Baseline const& base, Baseline const& current,
+		BaselineDiffOptions const& options = BaselineDiffOptions());
+// reorders the result of diffBaselines(); the sort is stable
+void sortBaselineDiff(std::vector<BaselineSectionDiff> &diff, BaselineDiffRanking ranking);
+
+} /* namespace perf */
+
+#endif /* PERF_BASELINE_H_ */
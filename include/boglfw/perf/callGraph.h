@@ -9,16 +9,21 @@
 #define PERF_CALLGRAPH_H_
 
 #include "section.h"
+#include "allocTracker.h"
 
 #include <stack>
-#include <unordered_map>
+#include <vector>
+#include <string>
 #include <memory>
+#include <deque>
+#include <mutex>
 
 namespace perf {
 
 class CallGraph {
 public:
-	static void pushSection(const char name[], bool deadTime);
+	// id must come from internSectionName()
+	static void pushSection(unsigned id, bool deadTime);
 	static void popSection(uint64_t nanoseconds);
 
 	static std::string getCrtThreadName() {
@@ -27,33 +32,30 @@ public:
 
 private:
 	friend class Results;
+	friend class AllocationTracker;
 	friend void setCrtThreadName(std::string name);
 
 	CallGraph() {}
 	static CallGraph& getCrtThreadInstance();
 
-	struct charArrHash {
-		size_t operator()(const char* s) const {
-			size_t h = 5381;
-			int c;
-			const char* s0 = s;
-			while ((c = *s0++))
-				h = ((h << 5) + h) + c;
-			return h;
-		}
-	};
-
 	std::string threadName_;
 
-	// this structure holds cummulated data for each section
+	// this structure holds cummulated data for each section, indexed by section ID
 	// (if a section is called from multiple other sections, all the timings here are aggregate)
-	std::unordered_map<const char*, std::unique_ptr<sectionData>, charArrHash> flatSectionData_;
+	std::vector<std::unique_ptr<sectionData>> flatSectionData_;
 
 	// this holds call-tree data - a section with the same name may exist in multiple instances if called from different places
 	std::vector<std::shared_ptr<sectionData>> rootTrees_;
+	std::vector<unsigned> rootTreeIds_;	// same order as rootTrees_
 
 	std::stack<sectionData*> crtStack_;
 
+	// allocations made on this thread by each section (exclusive), indexed by section ID; only used with PERF_TRACK_ALLOCATIONS.
+	// a deque so the elements never move when it grows; growing is locked against the readers.
+	std::deque<allocStats> allocStatsById_;
+	std::mutex allocStatsMutex_;
+	allocStats& getAllocStats(unsigned id);
+
 	static thread_local std::shared_ptr<CallGraph> crtThreadInstance_;
 };
 
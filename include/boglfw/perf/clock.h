@@ -0,0 +1,66 @@
+/*
+ * clock.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef PERF_CLOCK_H_
+#define PERF_CLOCK_H_
+
+#include <chrono>
+#include <cstdint>
+
+// define PERF_TSC_CLOCK to let the perf markers read time from the CPU's time stamp counter (x86 only)
+#if defined(PERF_TSC_CLOCK) && (defined(__x86_64__) || defined(__i386__))
+#define PERF_TSC_CLOCK_ENABLED
+#include <x86intrin.h>
+#endif
+
+namespace perf {
+
+/*
+ * The time source used by the perf markers and FrameCapture.
+ * It has the same epoch and units as std::chrono::steady_clock, but when built with PERF_TSC_CLOCK and the CPU
+ * has an invariant TSC, it reads the time stamp counter (a few ns) instead of going through clock_gettime
+ * (20-40 ns on some VMs). The TSC frequency is calibrated against steady_clock at startup;
+ * on CPUs without an invariant TSC it falls back to steady_clock.
+ */
+class Clock {
+public:
+	using duration = std::chrono::nanoseconds;
+	using rep = duration::rep;
+	using period = duration::period;
+	using time_point = std::chrono::time_point<Clock, duration>;
+	static constexpr bool is_steady = true;
+
+	static time_point now() {
+#ifdef PERF_TSC_CLOCK_ENABLED
+		if (tsc_.available) {
+			uint64_t delta = __rdtsc() - tsc_.tscBase;
+			return time_point(duration(tsc_.nanosecBase + (int64_t)(((unsigned __int128)delta * tsc_.nanosecPerTickFx32) >> 32)));
+		}
+#endif
+		return time_point(std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()));
+	}
+
+	// returns true if the time stamp counter is being used
+	static bool isUsingTsc() { return tsc_.available; }
+	// returns the calibrated TSC frequency in Hz (0 if not using the TSC)
+	static double getTscFrequency() { return tsc_.frequency; }
+
+private:
+	struct tscCalibration {
+		bool available = false;
+		uint64_t tscBase = 0;
+		int64_t nanosecBase = 0;			// steady_clock time corresponding to tscBase
+		uint64_t nanosecPerTickFx32 = 0;	// nanoseconds per TSC tick, 32.32 fixed point
+		double frequency = 0;
+	};
+	static tscCalibration tsc_;
+	static tscCalibration calibrate();
+};
+
+} /* namespace perf */
+
+#endif /* PERF_CLOCK_H_ */
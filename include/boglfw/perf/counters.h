@@ -0,0 +1,123 @@
+/*
+ * counters.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef PERF_COUNTERS_H_
+#define PERF_COUNTERS_H_
+
+#include "clock.h"
+
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+/*
+ * PERF_COUNTER accumulates a value over a frame (number of draw calls, bytes uploaded, etc.) - the value is reset
+ * on each frame boundary. PERF_GAUGE sets a value that persists until set again (number of entities, pool sizes).
+ * Both are compiled out together with the markers (DISABLE_PERF_MARKERS); the arguments are not evaluated then.
+ */
+#ifndef DISABLE_PERF_MARKERS
+	#define PERF_COUNTER_COMBINE1(X,Y) X##Y
+	#define PERF_COUNTER_COMBINE(X,Y) PERF_COUNTER_COMBINE1(X,Y)
+	#define PERF_COUNTER(NAME, DELTA) do { \
+		static const unsigned PERF_COUNTER_COMBINE(perfCounterId,__LINE__) = perf::registerCounter(NAME, perf::CounterKind::Counter); \
+		perf::Counters::add(PERF_COUNTER_COMBINE(perfCounterId,__LINE__), DELTA); \
+	} while (0)
+	#define PERF_GAUGE(NAME, VALUE) do { \
+		static const unsigned PERF_COUNTER_COMBINE(perfGaugeId,__LINE__) = perf::registerCounter(NAME, perf::CounterKind::Gauge); \
+		perf::Counters::set(PERF_COUNTER_COMBINE(perfGaugeId,__LINE__), VALUE); \
+	} while (0)
+#else
+	#define PERF_COUNTER(NAME, DELTA)
+	#define PERF_GAUGE(NAME, VALUE)
+#endif
+
+namespace perf {
+
+struct TraceCounterSample;
+
+enum class CounterKind {
+	Counter,	// accumulates per frame
+	Gauge,		// holds the last value set
+};
+
+// returns a unique ID for the counter; the same name always yields the same ID (and must always be used with the same kind).
+// this involves a lock, so the macros call it once per call site and keep the result in a static.
+unsigned registerCounter(const char name[], CounterKind kind);
+
+struct CounterValue {
+	std::string name;
+	CounterKind kind;
+	double lastFrameValue;	// accumulated during the last frame for counters, the current value for gauges
+	double total;			// accumulated since startup for counters, the current value for gauges
+};
+
+class Counters {
+public:
+	static constexpr unsigned maxCounters = 256;
+
+	// lock-free; each thread accumulates into its own slots, which are summed up at frame boundaries
+	static void add(unsigned id, int64_t delta) {
+		auto &slot = getThreadSlots().values_[id];
+		slot.store(slot.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+	}
+	static void set(unsigned id, double value) {
+		gauges_[id].store(value, std::memory_order_relaxed);
+	}
+
+	// call this once per frame (from the main loop) to take the per-frame snapshot of all counters
+	static void frameBoundary();
+
+	// returns all the counters as of the last frame boundary
+	static std::vector<CounterValue> getSnapshot();
+	// returns the value of one counter as of the last frame boundary
+	static double getLastFrameValue(unsigned id);
+	// same as above, by name (slower); returns 0 for counters that haven't been registered yet
+	static double getLastFrameValue(std::string const& name);
+
+	// the number of per-frame snapshots that are kept for export (default 600)
+	static void setHistorySize(unsigned frames);
+	// returns the per-frame values recorded since the given time, as trace counter samples
+	// with times relative to origin (pass FrameCapture::getCaptureStartTime() to match a frame capture)
+	static std::vector<TraceCounterSample> getTraceSamples(Clock::time_point since, Clock::time_point origin);
+
+private:
+	friend unsigned registerCounter(const char[], CounterKind);
+
+	// one extra slot to absorb the counters registered beyond maxCounters
+	static constexpr unsigned slotCount = maxCounters + 1;
+
+	struct threadSlots {
+		std::atomic<int64_t> values_[slotCount] {};
+	};
+
+	struct frameSnapshot {
+		Clock::time_point time;
+		std::vector<double> values;
+	};
+
+	static std::atomic<double> gauges_[slotCount];
+	static std::mutex mutex_;	// guards everything below
+	static std::vector<std::shared_ptr<threadSlots>> allThreadSlots_;
+	static std::vector<int64_t> lastTotals_;
+	static std::vector<double> lastFrameValues_;
+	static std::deque<frameSnapshot> history_;
+	static unsigned historySize_;
+
+	static threadSlots& getThreadSlots() {
+		static thread_local threadSlots* slots = createThreadSlots();
+		return *slots;
+	}
+	static threadSlots* createThreadSlots();
+};
+
+} /* namespace perf */
+
+#endif /* PERF_COUNTERS_H_ */
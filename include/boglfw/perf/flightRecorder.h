@@ -0,0 +1,66 @@
+/*
+ * flightRecorder.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef PERF_FLIGHTRECORDER_H_
+#define PERF_FLIGHTRECORDER_H_
+
+#include <string>
+#include <deque>
+#include <thread>
+#include <cstdint>
+
+namespace perf {
+
+struct FlightRecorderConfig {
+	// a frame longer than this triggers a dump
+	float spikeThresholdMs = 50.f;
+	// how many frames before the spiking one to include in the dump
+	unsigned framesBefore = 30;
+	// how many frames after the spiking one to include in the dump
+	unsigned framesAfter = 5;
+	// dumps are written as <outputPrefix><n>.json (Chrome trace format, see traceExport.h)
+	std::string outputPrefix = "spike-";
+	// stop dumping after this many files have been written
+	unsigned maxDumps = 20;
+};
+
+/*
+ * Keeps a FrameCapture running continuously on all threads (the per-thread ring buffers only hold the most recent records)
+ * and automatically writes the window around any frame that takes longer than the configured threshold.
+ * Call frameBoundary() once per frame from the main loop, after perf::Counters::frameBoundary() if the dumps should include
+ * the counters of the last frame; all methods must be called from the same thread.
+ * Size the ring buffers with FrameCapture::setThreadBufferCapacity() so they can hold the whole window.
+ */
+class FlightRecorder {
+public:
+	// starts the underlying FrameCapture - there must be no other capture in progress
+	static void start(FlightRecorderConfig const& config = FlightRecorderConfig());
+	// stops recording and waits for any dump in progress to be written
+	static void stop();
+	static bool isRunning() { return running_; }
+
+	// marks the end of a frame and the beginning of the next one
+	static void frameBoundary();
+
+	// returns the number of dumps written since start()
+	static unsigned getDumpCount() { return dumpCount_; }
+
+private:
+	static FlightRecorderConfig config_;
+	static bool running_;
+	static std::deque<uint64_t> frameStarts_;	// capture-relative start times of the most recent frames
+	static uint64_t windowStart_;				// start of the window to dump, valid while dumpCountdown_ > 0
+	static unsigned dumpCountdown_;				// frames left until the pending dump is written (0 = none pending)
+	static unsigned dumpCount_;
+	static std::thread writerThread_;
+
+	static void dump();
+};
+
+} /* namespace perf */
+
+#endif /* PERF_FLIGHTRECORDER_H_ */
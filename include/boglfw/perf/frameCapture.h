@@ -9,6 +9,7 @@
 #define PERF_FRAMECAPTURE_H_
 
 #include "callGraph.h"
+#include "clock.h"
 
 #include "../utils/MTVector.h"
 
@@ -16,9 +17,11 @@
 #include <thread>
 #include <chrono>
 #include <cassert>
-#include <cstring>
+#include <cstdint>
 #include <atomic>
 #include <memory>
+#include <limits>
+#include <map>
 
 namespace perf {
 
@@ -30,20 +33,22 @@ public:
 		AllThreads,
 	};
 
+	// one marker execution; names are only resolved when the data is exported
 	struct frameData {
-		std::chrono::time_point<std::chrono::high_resolution_clock> startTime_;
-		std::chrono::time_point<std::chrono::high_resolution_clock> endTime_;
-		char name_[256];
-		unsigned threadIndex_;
+		uint64_t startNanosec_;		// relative to the start of the capture
+		uint64_t durationNanosec_;
+		uint32_t nameId_;			// interned section name, see getSectionName()
+		uint16_t threadIndex_;
 		bool deadTime_;
 
-		frameData(const char name[], std::chrono::time_point<std::chrono::high_resolution_clock> start,
-				unsigned threadIndex, bool deadTime)
-			: startTime_(start), threadIndex_(threadIndex), deadTime_(deadTime) {
-			strncpy(name_, name, sizeof(name_)/sizeof(name_[0]) - 1);
-		}
+		std::string getName() const { return getSectionName(nameId_); }
+		uint64_t getEndNanosec() const { return startNanosec_ + durationNanosec_; }
 	};
 
+	// sets the number of records each thread can hold (before the oldest ones are overwritten).
+	// affects only threads that haven't recorded anything yet, so call it early.
+	static void setThreadBufferCapacity(size_t records) { bufferCapacity_.store(records, std::memory_order_relaxed); }
+
 	// start capturing a frame, recording all markers' absolute times
 	static void start(CaptureMode mode);
 	// stop capturing the frame
@@ -53,6 +58,22 @@ public:
 	// ordered chronologically, with interleaved threads
 	static std::vector<frameData> getResults();
 
+	// returns a copy of the records (from all threads) which end at or after fromNanosec, without stopping the capture.
+	// records overwritten while copying are dropped and frames that are still open are reported as ending now.
+	// the result is ordered chronologically like getResults().
+	static std::vector<frameData> getSnapshot(uint64_t fromNanosec = 0);
+
+	// returns the time when the current (or last) capture was started
+	static Clock::time_point getCaptureStartTime() { return captureStartTime_; }
+
+	// returns the number of nanoseconds elapsed since the capture was started
+	static uint64_t getCaptureTime() {
+		return std::chrono::nanoseconds(Clock::now() - captureStartTime_).count();
+	}
+
+	// builds the duration histogram of each section (by section id) from a set of captured records
+	static std::map<unsigned, LatencyHistogram> getSectionHistograms(std::vector<frameData> const& data);
+
 	// returns the name of the thread identified by index (use index from frameData)
 	static std::string getThreadNameForIndex(unsigned index);
 
@@ -62,6 +83,17 @@ public:
 private:
 	friend class Marker;
 
+	static constexpr uint64_t openDuration = std::numeric_limits<uint64_t>::max();
+
+	// fixed-size ring of records, written only by its own thread
+	struct threadBuffer {
+		std::unique_ptr<frameData[]> records_;
+		size_t capacity_;
+		std::atomic<uint64_t> writeSeq_ { 0 };	// total number of records written since the last cleanup
+
+		threadBuffer(size_t capacity) : records_(new frameData[capacity]), capacity_(capacity) {}
+	};
+
 	static bool captureEnabledOnThisThread() {
 		auto mode = mode_.load(std::memory_order_acquire);
 		if (mode == Disabled)
@@ -69,37 +101,65 @@ private:
 		return (mode == AllThreads || std::this_thread::get_id() == exclusiveThreadID_.load(std::memory_order_consume));
 	}
 
-	static void beginFrame(const char name[], std::chrono::time_point<std::chrono::high_resolution_clock> now, bool deadTime) {
+	static void beginFrame(unsigned sectionId, Clock::time_point now, bool deadTime) {
 		auto &ti = getThreadInstance();
-		ti.frames_->emplace_back(name, now, ti.threadIndex_, deadTime);
-		ti.frameStack_.push(ti.frames_->size()-1);
+		ti.checkGeneration();
+		auto &buf = *ti.buffer_;
+		uint64_t seq = buf.writeSeq_.load(std::memory_order_relaxed);
+		frameData &f = buf.records_[seq % buf.capacity_];
+		f.startNanosec_ = std::chrono::nanoseconds(now - captureStartTime_).count();
+		f.durationNanosec_ = openDuration;
+		f.nameId_ = sectionId;
+		f.threadIndex_ = ti.threadIndex_;
+		f.deadTime_ = deadTime;
+		buf.writeSeq_.store(seq + 1, std::memory_order_release);
+		ti.frameStack_.push_back(seq);
 	}
 
-	static void endFrame(std::chrono::time_point<std::chrono::high_resolution_clock> now) {
-		if (!getThreadInstance().frameStack_.size()) {
-			beginFrame("{UNKNOWN}", captureStartTime_, true);
-		}
+	static void endFrame(Clock::time_point now) {
 		auto &ti = getThreadInstance();
-		(*ti.frames_)[ti.frameStack_.top()].endTime_ = now;
-		ti.frameStack_.pop();
+		ti.checkGeneration();
+		if (ti.frameStack_.empty()) {
+			static const unsigned unknownId = internSectionName("{UNKNOWN}");
+			beginFrame(unknownId, captureStartTime_, true);
+		}
+		auto &buf = *ti.buffer_;
+		uint64_t seq = ti.frameStack_.back();
+		ti.frameStack_.pop_back();
+		if (buf.writeSeq_.load(std::memory_order_relaxed) - seq > buf.capacity_)
+			return;	// the record has been overwritten in the mean time
+		frameData &f = buf.records_[seq % buf.capacity_];
+		f.durationNanosec_ = std::chrono::nanoseconds(now - captureStartTime_).count() - f.startNanosec_;
 	}
 
 	static std::atomic<CaptureMode> mode_;
 	static std::atomic<std::thread::id> exclusiveThreadID_;
-	static MTVector<std::shared_ptr<std::vector<frameData>>> allFrames_;
+	static std::atomic<size_t> bufferCapacity_;
+	static std::atomic<unsigned> generation_;	// incremented on each start(), to discard stale open frames
+	static MTVector<std::shared_ptr<threadBuffer>> allFrames_;
 	static MTVector<std::string> threadNames_;
-	static std::chrono::time_point<std::chrono::high_resolution_clock> captureStartTime_;
+	static Clock::time_point captureStartTime_;
 
-	std::shared_ptr<std::vector<frameData>> frames_;
-	std::stack<int> frameStack_;
+	std::shared_ptr<threadBuffer> buffer_;
+	std::vector<uint64_t> frameStack_;	// sequence numbers of the open records
+	unsigned seenGeneration_ = 0;
 	unsigned threadIndex_;
+
+	void checkGeneration() {
+		auto g = generation_.load(std::memory_order_relaxed);
+		if (g != seenGeneration_) {
+			frameStack_.clear();
+			seenGeneration_ = g;
+		}
+	}
+
 	static FrameCapture& getThreadInstance() {
 		static thread_local FrameCapture instance;
 		return instance;
 	}
-	FrameCapture() : frames_(new std::vector<frameData>()) {
-		frames_->reserve(1024);
-		allFrames_.push_back(frames_);
+	FrameCapture() : buffer_(new threadBuffer(bufferCapacity_.load(std::memory_order_relaxed))) {
+		frameStack_.reserve(64);
+		allFrames_.push_back(buffer_);
 		threadIndex_ = threadNames_.push_back(CallGraph::getCrtThreadName());
 	}
 };
@@ -0,0 +1,119 @@
+/*
+ * latencyHistogram.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef PERF_LATENCYHISTOGRAM_H_
+#define PERF_LATENCYHISTOGRAM_H_
+
+#include <cstdint>
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+namespace perf {
+
+/*
+ * Log-linear histogram of durations (HDR-style): each power of two range is split into a fixed number of
+ * linear sub-buckets, which bounds the relative error of any percentile to 1/subBucketCount (12.5%)
+ * while keeping the histogram small and cheap to update.
+ * Values up to ~2^40 ns (18 minutes) are tracked, larger ones are counted in the last bucket.
+ * Histograms are additive, so the ones recorded on different threads can be merged.
+ */
+class LatencyHistogram {
+public:
+	static constexpr unsigned subBucketBits = 3;
+	static constexpr unsigned subBucketCount = 1 << subBucketBits;
+	static constexpr unsigned maxValueBits = 40;
+	static constexpr unsigned bucketCount = (maxValueBits - subBucketBits + 1) * subBucketCount;
+
+	void record(uint64_t nanosec) {
+		counts_[bucketIndex(nanosec)]++;
+		count_++;
+		if (nanosec > max_)
+			max_ = nanosec;
+		if (nanosec < min_)
+			min_ = nanosec;
+	}
+
+	void merge(LatencyHistogram const& other) {
+		for (unsigned i=0; i<bucketCount; i++)
+			counts_[i] += other.counts_[i];
+		count_ += other.count_;
+		max_ = std::max(max_, other.max_);
+		min_ = std::min(min_, other.min_);
+	}
+
+	void reset() {
+		*this = LatencyHistogram();
+	}
+
+	uint64_t getCount() const { return count_; }
+	uint64_t getMax() const { return max_; }
+	uint64_t getMin() const { return count_ ? min_ : 0; }
+
+	// returns the value below which p percent of the recorded values lie (p in [0, 100]);
+	// the result is the upper bound of the bucket containing the percentile, clamped to the recorded range.
+	uint64_t getPercentile(double p) const {
+		if (count_ == 0)
+			return 0;
+		uint64_t rank = (uint64_t)(p / 100 * count_ + 0.5);
+		rank = std::max<uint64_t>(1, std::min(rank, count_));
+		uint64_t acc = 0;
+		for (unsigned i=0; i<bucketCount; i++) {
+			acc += counts_[i];
+			if (acc >= rank)
+				return std::max(min_, std::min(max_, bucketUpperBound(i)));
+		}
+		return max_;
+	}
+
+	// standard deviation of the recorded values around the given mean, estimated from the bucket midpoints
+	double getStdDev(double mean) const {
+		if (count_ < 2)
+			return 0;
+		double sum = 0;
+		for (unsigned i=0; i<bucketCount; i++) {
+			if (!counts_[i])
+				continue;
+			double lower = i ? bucketUpperBound(i-1) + 1 : 0;
+			double mid = (lower + bucketUpperBound(i)) * 0.5;
+			sum += counts_[i] * (mid - mean) * (mid - mean);
+		}
+		return std::sqrt(sum / (count_ - 1));
+	}
+
+	uint64_t getP50() const { return getPercentile(50); }
+	uint64_t getP90() const { return getPercentile(90); }
+	uint64_t getP99() const { return getPercentile(99); }
+
+	static unsigned bucketIndex(uint64_t value) {
+		if (value < subBucketCount)
+			return value;
+		unsigned msb = 63 - __builtin_clzll(value);
+		if (msb >= maxValueBits)
+			return bucketCount - 1;
+		return (msb - subBucketBits + 1) * subBucketCount + (unsigned)(value >> (msb - subBucketBits)) - subBucketCount;
+	}
+
+	// returns the largest value that falls into bucket i
+	static uint64_t bucketUpperBound(unsigned i) {
+		if (i < subBucketCount)
+			return i;
+		unsigned shift = i / subBucketCount - 1;
+		uint64_t mantissa = i % subBucketCount + subBucketCount;
+		return ((mantissa + 1) << shift) - 1;
+	}
+
+private:
+	std::array<uint32_t, bucketCount> counts_ {};
+	uint64_t count_ = 0;
+	uint64_t max_ = 0;
+	uint64_t min_ = UINT64_MAX;
+};
+
+} /* namespace perf */
+
+#endif /* PERF_LATENCYHISTOGRAM_H_ */
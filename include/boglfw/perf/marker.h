@@ -9,42 +9,86 @@
 #define PERF_MARKER_H_
 
 #include "callGraph.h"
+#include "clock.h"
 #include "frameCapture.h"
+#include "markerCategory.h"
 
 #include <chrono>
 
-#ifdef ENABLE_PERF_MARKERS
+/*
+ * Markers are compiled in unless DISABLE_PERF_MARKERS is defined, and are switched on and off at runtime
+ * with perf::setMarkersEnabled() / perf::setEnabledMarkerCategories().
+ * A disabled marker costs one load and one well predicted branch.
+ * Markers start enabled if ENABLE_PERF_MARKERS is defined when building the library, otherwise disabled.
+ */
+#ifndef DISABLE_PERF_MARKERS
 	#define COMBINE1(X,Y) X##Y  // helper macro
 	#define COMBINE(X,Y) COMBINE1(X,Y)
-	#define PERF_MARKER_FUNC perf::Marker COMBINE(funcMarker,__LINE__)(__PRETTY_FUNCTION__)
-	#define PERF_MARKER_FUNC_BLOCKED perf::Marker COMBINE(funcMarker,__LINE__)(__PRETTY_FUNCTION__, true)
-	#define PERF_MARKER(NAME) perf::Marker COMBINE(perfMarker, __LINE__)(NAME)
-	#define PERF_MARKER_BLOCKED(NAME) perf::Marker COMBINE(perfMarker,__LINE__)(NAME, true)
+	// the section name is interned once per call site into a function-local static ID
+	#define PERF_MARKER_IMPL(NAME, BLOCKED, CATEGORY) \
+		static const unsigned COMBINE(perfMarkerId,__LINE__) = perf::internSectionName(NAME); \
+		perf::Marker COMBINE(perfMarker,__LINE__)(COMBINE(perfMarkerId,__LINE__), BLOCKED, CATEGORY)
+	#define PERF_MARKER_FUNC PERF_MARKER_IMPL(__PRETTY_FUNCTION__, false, perf::MarkerCategory::General)
+	#define PERF_MARKER_FUNC_BLOCKED PERF_MARKER_IMPL(__PRETTY_FUNCTION__, true, perf::MarkerCategory::General)
+	#define PERF_MARKER(NAME) PERF_MARKER_IMPL(NAME, false, perf::MarkerCategory::General)
+	#define PERF_MARKER_BLOCKED(NAME) PERF_MARKER_IMPL(NAME, true, perf::MarkerCategory::General)
+	// same as above, but the marker belongs to a category (one of perf::MarkerCategory) which can be switched separately
+	#define PERF_MARKER_FUNC_CAT(CATEGORY) PERF_MARKER_IMPL(__PRETTY_FUNCTION__, false, CATEGORY)
+	#define PERF_MARKER_CAT(CATEGORY, NAME) PERF_MARKER_IMPL(NAME, false, CATEGORY)
+	// use this when the name is built at runtime (it's looked up on each execution, so it's slower);
+	// the NAME expression is only evaluated when the marker is enabled
+	#define PERF_MARKER_DYNAMIC(NAME) perf::Marker COMBINE(perfMarker,__LINE__)(perf::MarkerCategory::General, \
+		[&] { return perf::internSectionName(NAME); })
 #else
 	#define PERF_MARKER_FUNC
 	#define PERF_MARKER_FUNC_BLOCKED
 	#define PERF_MARKER(NAME)
 	#define PERF_MARKER_BLOCKED(NAME)
+	#define PERF_MARKER_FUNC_CAT(CATEGORY)
+	#define PERF_MARKER_CAT(CATEGORY, NAME)
+	#define PERF_MARKER_DYNAMIC(NAME)
 #endif
 
 namespace perf {
 
+// enable or disable all markers; the selected categories are kept while markers are disabled
+void setMarkersEnabled(bool enabled);
+bool getMarkersEnabled();
+// set the mask of marker categories that are enabled while markers are enabled
+void setEnabledMarkerCategories(unsigned categoryMask);
+unsigned getEnabledMarkerCategories();
+
 inline void setCrtThreadName(std::string name) {
 	CallGraph::getCrtThreadInstance().threadName_ = name;
 }
 
 class Marker {
 public:
-	Marker(const char name[], bool blocked = false) {
-		CallGraph::pushSection(name, blocked);
-		start_ = std::chrono::high_resolution_clock::now();
-		if (FrameCapture::captureEnabledOnThisThread()) {
-			FrameCapture::beginFrame(name, start_, blocked);
-		}
+	// id must come from internSectionName()
+	Marker(unsigned id, bool blocked = false, unsigned category = MarkerCategory::General)
+		: active_(isMarkerCategoryEnabled(category)) {
+		if (active_)
+			begin(id, blocked);
+	}
+
+	Marker(const char name[], bool blocked = false, unsigned category = MarkerCategory::General)
+		: active_(isMarkerCategoryEnabled(category)) {
+		if (active_)
+			begin(internSectionName(name), blocked);
+	}
+
+	// getId() (returning an id from internSectionName()) is only called if the marker is enabled
+	template <class GetId>
+	Marker(unsigned category, GetId &&getId, bool blocked = false)
+		: active_(isMarkerCategoryEnabled(category)) {
+		if (active_)
+			begin(getId(), blocked);
 	}
 
 	~Marker() {
-		auto end = std::chrono::high_resolution_clock::now();
+		if (!active_)
+			return;
+		auto end = Clock::now();
 		auto nanosec = std::chrono::nanoseconds(end - start_).count();
 		CallGraph::popSection(nanosec);
 		if (FrameCapture::captureEnabledOnThisThread()) {
@@ -53,7 +97,17 @@ public:
 	}
 
 private:
-	std::chrono::time_point<std::chrono::high_resolution_clock> start_;
+	void begin(unsigned id, bool blocked) {
+		CallGraph::pushSection(id, blocked);
+		start_ = Clock::now();
+		if (FrameCapture::captureEnabledOnThisThread()) {
+			FrameCapture::beginFrame(id, start_, blocked);
+		}
+	}
+
+	// decided once at construction, so toggling markers while a section is open keeps the call graph balanced
+	bool active_;
+	Clock::time_point start_;
 };
 
 } // namespace perf
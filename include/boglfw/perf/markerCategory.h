@@ -0,0 +1,46 @@
+/*
+ * markerCategory.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef PERF_MARKERCATEGORY_H_
+#define PERF_MARKERCATEGORY_H_
+
+#include <atomic>
+
+// kept apart from marker.h so that low level code (such as ProfiledMutex, which the perf containers use)
+// can check the switches without including the whole perf module
+
+namespace perf {
+
+// marker categories are bit flags; user code may define its own from User upwards
+namespace MarkerCategory {
+	enum : unsigned {
+		General		= 1 << 0,
+		Update		= 1 << 1,
+		Render		= 1 << 2,
+		Physics		= 1 << 3,
+		Threading	= 1 << 4,
+		IO			= 1 << 5,
+		User		= 1 << 8,
+
+		All			= ~0u
+	};
+}
+
+namespace detail {
+	// the selected categories while markers are enabled, zero while they're disabled; keeping both switches in one
+	// word is what lets a disabled marker cost a single load and branch
+	extern std::atomic<unsigned> enabledMarkerCategories_;
+}
+
+// true if markers are enabled and any of the categories in the mask is selected
+inline bool isMarkerCategoryEnabled(unsigned categoryMask) {
+	return (detail::enabledMarkerCategories_.load(std::memory_order_relaxed) & categoryMask) != 0;
+}
+
+} // namespace perf
+
+#endif /* PERF_MARKERCATEGORY_H_ */
@@ -7,6 +7,9 @@
 
 #include <boglfw/perf/section.h>
 #include <boglfw/perf/frameCapture.h>
+#include <boglfw/perf/allocTracker.h>
+#include <boglfw/perf/baseline.h>
+#include <boglfw/perf/profiledMutex.h>
 
 #include <vector>
 #include <memory>
@@ -14,6 +17,12 @@
 void printCallTree(std::vector<std::shared_ptr<perf::sectionData>> t, int level);
 void printTopHits(std::vector<perf::sectionData> data);
 void printFrameCaptureData(std::vector<perf::FrameCapture::frameData> data);
+void printTopAllocators(std::vector<perf::AllocationTracker::SectionAllocations> const& data);
+// prints the maxRows largest changes of a baseline diff, ranked both by absolute and by relative change,
+// followed by a summary of regressions/improvements
+void printBaselineDiff(std::vector<perf::BaselineSectionDiff> const& diff, unsigned maxRows);
+// prints the locks that were acquired at least once
+void printLockStats(std::vector<perf::LockStats> const& stats);
 
 void printCallFrame(perf::sectionData const& s, bool flatMode=false);
 void dumpFrameCaptureData(std::vector<perf::FrameCapture::frameData> data);
@@ -0,0 +1,122 @@
+/*
+ * profiledMutex.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef PERF_PROFILEDMUTEX_H_
+#define PERF_PROFILEDMUTEX_H_
+
+#include "clock.h"
+#include "markerCategory.h"
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace perf {
+
+// statistics accumulated for all the locks sharing a name
+struct LockStats {
+	std::string name;
+	uint64_t acquisitions;
+	uint64_t contentions;		// how many acquisitions had to wait for another thread
+	uint64_t waitNanosec;		// total time spent waiting to acquire
+	uint64_t maxWaitNanosec;
+	uint64_t holdNanosec;		// total time the lock was held
+};
+
+/*
+ * A drop-in replacement for std::mutex (works with std::lock_guard, std::unique_lock, std::lock and
+ * std::condition_variable_any) that records acquisition count, contention count, wait and hold time per lock name.
+ * Statistics are only recorded while MarkerCategory::Threading markers are enabled; otherwise locking is
+ * one load and branch plus a plain std::mutex lock.
+ * When recording, the uncontended path is a try_lock plus two clock reads; when the lock is contended the wait
+ * is recorded as a blocked perf section named "lock-wait: <name>", so it shows up as dead time
+ * in the call graph and in FrameCapture.
+ * A null name makes the mutex behave like a plain std::mutex - the perf module's own containers use that,
+ * since recording a section while they are being locked would recurse into them.
+ */
+class ProfiledMutex {
+public:
+	// the name must be a string literal or otherwise outlive the mutex
+	explicit ProfiledMutex(const char name[]);
+	ProfiledMutex(ProfiledMutex const&) = delete;
+	ProfiledMutex& operator = (ProfiledMutex const&) = delete;
+
+	void lock() {
+		if (!isRecording()) {
+			mutex_.lock();
+			timed_ = false;
+			return;
+		}
+		if (!mutex_.try_lock())
+			lockContended();
+		acquired();
+	}
+
+	bool try_lock() {
+		bool recording = isRecording();
+		if (!mutex_.try_lock())
+			return false;
+		if (recording)
+			acquired();
+		else
+			timed_ = false;
+		return true;
+	}
+
+	void unlock() {
+		if (timed_) {
+			auto held = std::chrono::nanoseconds(Clock::now() - acquireTime_).count();
+			stats_->holdNanosec.fetch_add(held, std::memory_order_relaxed);
+		}
+		mutex_.unlock();
+	}
+
+	const char* getName() const { return name_; }
+
+	// returns the statistics of all named locks, sorted by total wait time, descending
+	static std::vector<LockStats> getStats();
+	// resets the statistics of all named locks
+	static void resetStats();
+
+private:
+	friend struct lockRegistry;
+
+	struct namedStats {
+		std::atomic<uint64_t> acquisitions {0};
+		std::atomic<uint64_t> contentions {0};
+		std::atomic<uint64_t> waitNanosec {0};
+		std::atomic<uint64_t> maxWaitNanosec {0};
+		std::atomic<uint64_t> holdNanosec {0};
+		unsigned waitSectionId = 0;	// interned on first contention
+		std::atomic<bool> waitSectionValid {false};
+	};
+
+	std::mutex mutex_;
+	const char* name_;
+	namedStats* stats_ = nullptr;
+	// only touched by the owning thread:
+	Clock::time_point acquireTime_;
+	bool timed_ = false;	// decided when locking, so that switching the markers while the lock is held is harmless
+
+	bool isRecording() const {
+		return stats_ && isMarkerCategoryEnabled(MarkerCategory::Threading);
+	}
+
+	void acquired() {
+		acquireTime_ = Clock::now();
+		timed_ = true;
+		stats_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void lockContended();
+};
+
+} // namespace perf
+
+#endif /* PERF_PROFILEDMUTEX_H_ */
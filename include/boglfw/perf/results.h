@@ -8,6 +8,8 @@
 #ifndef PERF_RESULTS_H_
 #define PERF_RESULTS_H_
 
+#include "latencyHistogram.h"
+#include "counters.h"
 #include "../utils/MTVector.h"
 #include <memory>
 #include <vector>
@@ -19,6 +21,7 @@ class sectionData;
 
 class Results {
 	friend class CallGraph;
+	friend class AllocationTracker;
 public:
 
 	// return the number of threads that contain traced calls
@@ -30,14 +33,34 @@ public:
 	static std::vector<std::shared_ptr<sectionData>> getCallTrees(unsigned threadID);
 	// get a list of independent call trees on the specified named thread
 	static std::vector<std::shared_ptr<sectionData>> getCallTrees(std::string const& threadName);
+	// get the names of all the threads (each name only once, even if several threads share it)
+	static std::vector<std::string> getThreadNames();
+	// get the call trees of all the threads with the given name merged together: the nodes on the same call path
+	// are summed up and report how many threads contributed and how evenly (see sectionData::getThreadImbalance())
+	static std::vector<std::shared_ptr<sectionData>> getMergedCallTrees(std::string const& threadName);
+	// get the flat lists of all the threads with the given name merged together
+	static std::vector<sectionData> getMergedFlatList(std::string const& threadName);
+
 	// get a flat list of frames on the specified thread
 	static std::vector<sectionData> getFlatList(unsigned threadID);
 	// get a flat list of frames on the specified named thread
 	static std::vector<sectionData> getFlatList(std::string const& threadName);
 
+	// get the duration histogram of a section (id from internSectionName()) with the executions from all threads merged
+	static LatencyHistogram getMergedHistogram(unsigned sectionId);
+	static LatencyHistogram getMergedHistogram(std::string const& sectionName);
+
+	// get the values of all counters and gauges as of the last frame boundary (see counters.h)
+	static std::vector<CounterValue> getCounters() { return Counters::getSnapshot(); }
+
 private:
 	static MTVector<std::shared_ptr<CallGraph>> threadGraphs_;
 
+	// returns an empty section to merge the threads' data into
+	static std::shared_ptr<sectionData> makeMergedSection(unsigned id);
+	// adds src (from a single thread) into dst, recursively for the callees
+	static void mergeSection(sectionData &dst, sectionData const& src);
+
 	static void registerGraph(std::shared_ptr<CallGraph> graph) {
 		threadGraphs_.push_back(graph);
 	}
@@ -8,16 +8,29 @@
 #ifndef PERF_SECTION_H_
 #define PERF_SECTION_H_
 
+#include "latencyHistogram.h"
+
 #include <cstring>
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <memory>
 #include <numeric>
 
 namespace perf {
 
+// returns a unique ID for the section name; the same name always yields the same ID.
+// this involves a locked hash lookup, so markers call it once per call site and keep the result in a static.
+unsigned internSectionName(const char name[]);
+// returns the name of an interned section ID
+std::string getSectionName(unsigned id);
+// returns the number of interned names so far (IDs are allocated contiguously from zero)
+unsigned getSectionNameCount();
+
 class sectionData {
 public:
-	std::string getName() const { return name_; }
+	std::string getName() const { return getSectionName(id_); }
+	unsigned getId() const { return id_; }
 	bool isDeadTime() const { return deadTime_; }
 	uint64_t getInclusiveNanosec() const { return nanoseconds_; }
 	uint64_t getExclusiveNanosec() const { return nanoseconds_ - std::accumulate(callees_.begin(), callees_.end(), (uint64_t)0,
@@ -26,27 +39,44 @@ public:
 		});
 	}
 	unsigned getExecutionCount() const { return executionCount_; }
+	// distribution of the inclusive duration of individual executions
+	LatencyHistogram const& getHistogram() const { return histogram_; }
+	uint64_t getPercentileNanosec(double p) const { return histogram_.getPercentile(p); }
+	uint64_t getMaxNanosec() const { return histogram_.getMax(); }
+
+	// for sections merged across threads (see Results::getMergedCallTrees()) these describe the individual threads' share;
+	// for single-thread data the thread count is 1.
+	unsigned getThreadCount() const { return threadCount_; }
+	uint64_t getMaxThreadInclusiveNanosec() const { return threadCount_ > 1 ? maxThreadNanosec_ : nanoseconds_; }
+	// the busiest thread's inclusive time divided by the average per thread (1 means perfectly balanced)
+	float getThreadImbalance() const {
+		return threadCount_ > 1 && nanoseconds_ ? (float)maxThreadNanosec_ * threadCount_ / nanoseconds_ : 1.f;
+	}
 	const std::vector<std::shared_ptr<sectionData>>& getCallees() const { return callees_; }
 
 private:
 	friend class CallGraph;
+	friend class Results;
 
-	static std::shared_ptr<sectionData> make_shared(const char name[]) {
-		return std::shared_ptr<sectionData>(new sectionData(name));
+	static std::shared_ptr<sectionData> make_shared(unsigned id) {
+		return std::shared_ptr<sectionData>(new sectionData(id));
 	}
-	static std::unique_ptr<sectionData> make_unique(const char name[]) {
-		return std::unique_ptr<sectionData>(new sectionData(name));
+	static std::unique_ptr<sectionData> make_unique(unsigned id) {
+		return std::unique_ptr<sectionData>(new sectionData(id));
 	}
 
-	sectionData(const char name[]) {
-		strncpy(name_, name, sizeof(name_)/sizeof(name_[0]));
+	sectionData(unsigned id) : id_(id) {
 	}
 
 	uint64_t nanoseconds_ = 0;
 	uint64_t executionCount_ = 0;
-	char name_[256];
+	unsigned id_;
 	bool deadTime_ = false;
+	LatencyHistogram histogram_;
+	unsigned threadCount_ = 1;
+	uint64_t maxThreadNanosec_ = 0;
 	std::vector<std::shared_ptr<sectionData>> callees_;
+	std::vector<unsigned> calleeIds_;	// same order as callees_, kept separately so lookups scan a compact array
 };
 
 }
@@ -0,0 +1,58 @@
+/*
+ * threadPoolMonitor.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef PERF_THREADPOOLMONITOR_H_
+#define PERF_THREADPOOLMONITOR_H_
+
+#include "../utils/ThreadPool.h"
+
+#include <vector>
+
+namespace perf {
+
+/*
+ * Samples a ThreadPool's instrumentation counters on each update() and computes the values for the last interval.
+ * Enables the pool's instrumentation while it exists; the pool's statistics are reset on each update, so only
+ * one monitor should be attached to a pool at a time.
+ *
+ * The getters return plain floats so they can be fed into a SignalViewer:
+ * 		sigViewer.addSignal("pool usage", [&monitor] { return monitor.getUtilization(); }, ...);
+ */
+class ThreadPoolMonitor {
+public:
+	explicit ThreadPoolMonitor(ThreadPool &pool);
+	~ThreadPoolMonitor();
+
+	void update(float dt);
+
+	// fraction of the workers' time spent executing tasks [0..1]
+	float getUtilization() const { return utilization_; }
+	// busiest worker's busy time divided by the average busy time (1 means perfectly balanced)
+	float getImbalance() const { return imbalance_; }
+	float getTasksPerSecond() const { return tasksPerSecond_; }
+	float getAverageQueueDepth() const { return avgQueueDepth_; }
+	float getMaxQueueDepth() const { return maxQueueDepth_; }
+	// task wait-to-start latency percentile in microseconds (resolution is one power of two)
+	float getWaitPercentile(float percentile) const;
+
+	// raw statistics collected during the last interval
+	ThreadPool::Stats const& getLastStats() const { return lastStats_; }
+
+private:
+	ThreadPool &pool_;
+	ThreadPool::Stats lastStats_;
+	float utilization_ = 0;
+	float imbalance_ = 0;
+	float tasksPerSecond_ = 0;
+	float avgQueueDepth_ = 0;
+	float maxQueueDepth_ = 0;
+	std::vector<uint64_t> waitHistogram_;	// merged over all workers
+};
+
+} // namespace perf
+
+#endif /* PERF_THREADPOOLMONITOR_H_ */
@@ -0,0 +1,40 @@
+/*
+ * traceExport.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef PERF_TRACEEXPORT_H_
+#define PERF_TRACEEXPORT_H_
+
+#include "frameCapture.h"
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+namespace perf {
+
+// one value of a named counter, shown as a separate track in the trace viewer
+struct TraceCounterSample {
+	std::string name;
+	uint64_t timeNanosec;	// relative to the start of the capture, same as frameData::startNanosec_
+	double value;
+};
+
+// writes the frame capture data in Chrome Trace Event JSON format, loadable into chrome://tracing or Perfetto.
+// Each thread gets its own track named after its perf thread name; dead-time sections are put in the "blocked" category.
+// Events are written one by one, the document is never built in memory.
+// returns false if the output could not be written.
+bool exportChromeTrace(std::vector<FrameCapture::frameData> const& data, std::ostream &out,
+		std::vector<TraceCounterSample> const& counters = {});
+
+// same as above, but writes to a file which is created or overwritten
+bool exportChromeTrace(std::vector<FrameCapture::frameData> const& data, std::string const& filePath,
+		std::vector<TraceCounterSample> const& counters = {});
+
+} /* namespace perf */
+
+#endif /* PERF_TRACEEXPORT_H_ */
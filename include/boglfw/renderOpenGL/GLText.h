@@ -33,29 +33,32 @@ public:
 
 protected:
 	friend class RenderHelpers;
-	static void init(const char* fontPath); // path to font *.desc file
+	static void init(const char* fontPath, bool headless); // path to font *.desc file
 	static void unload();
 private:
-	GLText(const char * texturePath, int rows, int cols, char firstChar, int defaultSize);
-
-	unsigned textureID_;			// Texture containing the font
-	unsigned VAO_;
-	unsigned posVBO_;				// Buffer containing the vertices
-	unsigned uvVBO_;				// UVs
-	unsigned colorVBO_;				// vertex colors
-	unsigned shaderProgram_;		// Program used to render the text
-	unsigned indexViewportHalfSize_;
-	unsigned indexTranslation_;
-	unsigned u_textureID_;			// Location of the program's texture attribute
+	GLText(const char * texturePath, int rows, int cols, char firstChar, int defaultSize, bool headless);
+
+	unsigned textureID_ = 0;		// Texture containing the font
+	unsigned VAO_ = 0;
+	unsigned posVBO_ = 0;			// Buffer containing the vertices
+	unsigned uvVBO_ = 0;			// UVs
+	unsigned colorVBO_ = 0;			// vertex colors
+	unsigned shaderProgram_ = 0;	// Program used to render the text
+	unsigned indexViewportHalfSize_ = 0;
+	unsigned indexTranslation_ = 0;
+	unsigned u_textureID_ = 0;		// Location of the program's texture attribute
 	int rows_, cols_, firstChar_;
 	float cellRatio_; 					// cellWeight / cellHidth
 	int defaultSize_;					// text size from the texture
+	bool headless_;					// no GL resources, flush() only discards the buffers
 	std::vector<glm::vec2> vertices_;	// these are relative to item's position (below)
 	std::vector<glm::vec2> UVs_;
 	std::vector<glm::vec4> colors_;
 	std::vector<glm::vec2> itemPositions_;
 	std::vector<int> verticesPerItem_;
 
+	void purgeBuffers();
+
 	static bool disableMipMaps_;
 };
 
@@ -23,6 +23,9 @@ public:
 		bool disableMeshRenderer = false;
 		bool disableGLText = false;
 		bool disablePictureDraw = false;
+		// headless mode makes no GL calls: Shape2D and GLText only build their vertex data and flush() discards it,
+		// the other helpers are disabled. Used for benchmarking without a GPU.
+		bool headless = false;
 	};
 
 	static Config defaultConfig() { return Config{}; }
@@ -57,9 +57,9 @@ public:
 
 protected:
 	friend class RenderHelpers;
-	static void init();
+	static void init(bool headless);
 	static void unload();
-	Shape2D();
+	Shape2D(bool headless);
 
 private:
 	struct s_lineVertex {
@@ -91,6 +91,10 @@ private:
 	unsigned triangleVBO_ = 0;
 	unsigned triangleIBO_ = 0;
 	unsigned triangleVAO_ = 0;
+
+	bool headless_;	// no GL resources, flush() only discards the buffers
+
+	void purgeBuffers();
 };
 
 #endif /* RENDEROPENGL_SHAPE2D_H_ */
@@ -12,8 +12,31 @@
 #include <vector>
 #include <map>
 #include <cstdlib>
+#include <cstdint>
+
+#include "../utils/mappedFile.h"
+#include "../utils/compression.h"
 
 class BinaryStream;
+class ThreadPool;
+struct bigFile_tableEntry_v2;
+
+struct BigFileSaveOptions {
+	// version 1 is only useful for older readers; it's limited to 4 GB and has to be parsed when loaded
+	unsigned formatVersion = 2;
+	// version 2: the entry bodies start at multiples of this (a power of two: 64 for cache lines, 4096 for pages)
+	unsigned alignment = 64;
+	// version 2: the entries are compressed with this method (Compression::getPreferred() is the best one available);
+	// entries that don't get smaller are stored uncompressed
+	CompressionMethod compression = CompressionMethod::None;
+	int compressionLevel = 0;		// only used by Zstd; 0 is its default level
+	// if set, the entries are compressed in parallel on this pool (BigFile::saveToDisk() only)
+	ThreadPool* threadPool = nullptr;
+	// version 2 is written to a temporary file that replaces the destination when complete, so an interrupted save
+	// leaves the previous file. With fsync the data is also flushed to the disk (fsync) before and after the
+	// replacement, so that even a power loss leaves either the complete new file or the previous one
+	bool fsync = false;
+};
 
 class BigFile {
 public:
@@ -42,11 +65,23 @@ public:
 		friend class BigFile;
 	};
 
+	enum class LoadMode {
+		ReadAll,	// reads all the entries into memory
+		Mapped,		// memory-maps the file; the entries are views into the mapping and their pages are read from disk
+					// the first time they're accessed. The entries must not be written to, and the file must not be
+					// overwritten while this BigFile is alive. Compressed entries are decompressed into memory when loading.
+	};
+
 	BigFile() = default;
 	~BigFile() = default;
 
-	bool loadFromDisk(const std::string &path);
-	bool saveToDisk(const std::string &path);
+	// if a pool is given, compressed entries are decompressed in parallel on it
+	bool loadFromDisk(const std::string &path, LoadMode mode = LoadMode::ReadAll, ThreadPool* pool = nullptr);
+	bool saveToDisk(const std::string &path, BigFileSaveOptions const& options = {});
+
+	// Mapped mode: asks the OS to start reading an entry (or the whole file) ahead of use; does nothing otherwise
+	void prefetch(const std::string &name) const;
+	void prefetchAll() const;
 
 	const FileDescriptor getFile(const std::string &name) const;
 	const std::vector<FileDescriptor> getAllFiles() const;
@@ -57,9 +92,22 @@ public:
 
 private:
 	std::map<std::string, FileDescriptor> mapFiles;
+	MappedFile mapping_;
+	// a mapped version 2 file is used in place: these point into the mapping and its entries are not in mapFiles
+	const bigFile_tableEntry_v2* mappedEntries_ = nullptr;
+	const uint32_t* mappedBuckets_ = nullptr;
+	const char* mappedNames_ = nullptr;
+	uint32_t mappedCount_ = 0;
+	uint32_t mappedBucketMask_ = 0;
 
+	void unmap();
+	bool load(BinaryStream &fileStream, const std::string &path, ThreadPool* pool);
 	bool loadFromDisk_v1(BinaryStream &fileStream);
-	bool saveToDisk_v1(const std::string &path);
+	bool loadFromDisk_v2(BinaryStream &fileStream, const std::string &path, ThreadPool* pool);
+	bool saveToDisk_v1(const std::string &path, std::vector<FileDescriptor> const& files);
+	bool saveToDisk_v2(const std::string &path, std::vector<FileDescriptor> const& files, BigFileSaveOptions const& options);
+	const bigFile_tableEntry_v2* findMapped(const std::string &name) const;
+	FileDescriptor getMappedFile(bigFile_tableEntry_v2 const& entry) const;
 };
 
 #endif /* SERIALIZATION_BIGFILE_H_ */
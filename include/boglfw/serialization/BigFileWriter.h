@@ -0,0 +1,71 @@
+/*
+ * BigFileWriter.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef SERIALIZATION_BIGFILEWRITER_H_
+#define SERIALIZATION_BIGFILEWRITER_H_
+
+#include "BigFile.h"
+#include "BigFile_v2.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdio>
+#include <cstdint>
+
+/*
+ * Writes a version 2 BigFile in one pass: each entry goes to the disk as soon as it's added (compressed first if the
+ * options say so) and finish() writes the table after them.
+ * The memory used doesn't depend on the size of the archive: besides the compression buffer (as large as the
+ * largest entry) it keeps about 100 bytes plus the name for each entry, until finish().
+ * The destination only changes when finish() succeeds: until then, the data goes to a temporary file next to it.
+ */
+class BigFileWriter {
+public:
+	BigFileWriter() = default;
+	// an unfinished file is discarded
+	~BigFileWriter();
+
+	BigFileWriter(BigFileWriter const&) = delete;
+	BigFileWriter& operator = (BigFileWriter const&) = delete;
+
+	// starts writing the file as path + ".tmp"; an existing file at path is only replaced by finish().
+	// options.formatVersion must be 2, options.threadPool is not used
+	bool open(std::string const& path, BigFileSaveOptions const& options = {});
+	// writes an entry; the names must be unique. On failure the error is logged, the writer is closed
+	// and the unfinished file discarded.
+	bool addFile(std::string const& name, const void* buffer, size_t size);
+	// writes the table, closes the file and renames it over the destination
+	bool finish();
+	// closes and removes an unfinished file; the destination is left as it was
+	void abort();
+
+	bool isOpen() const { return file_ != nullptr; }
+	// the number of bytes written so far
+	uint64_t getSize() const { return offset_; }
+
+private:
+	FILE* file_ = nullptr;		// not an std::ofstream, because that can't be fsync'ed
+	std::string path_;
+	std::string tempPath_;		// path_ + ".tmp", renamed over path_ by finish()
+	BigFileSaveOptions options_;
+	uint64_t offset_ = 0;
+	std::vector<bigFile_tableEntry_v2> entries_;
+	std::string names_;
+	std::unordered_multimap<uint64_t, uint32_t> nameIndex_;	// name hash -> entry, for rejecting duplicate names
+	std::vector<char> compressBuffer_;
+
+	friend class BigFile;
+	// adds an entry whose body has already been compressed with the given method (or not, with None)
+	bool addStored(std::string const& name, uint64_t size, const void* body, uint64_t storedSize,
+			CompressionMethod method);
+	bool write(const void* data, size_t size);
+	bool writePadding(uint64_t alignment);
+	bool fail(bool logWriteError = true);
+};
+
+#endif /* SERIALIZATION_BIGFILEWRITER_H_ */
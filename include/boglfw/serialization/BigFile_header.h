@@ -0,0 +1,36 @@
+/*
+ * BigFile_header.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef SERIALIZATION_BIGFILE_HEADER_H_
+#define SERIALIZATION_BIGFILE_HEADER_H_
+
+#include "BinaryStream.h"
+
+#include <cstdint>
+
+// the beginning of every BigFile, regardless of version
+static constexpr uint32_t BIGFILE_MAGIC = 0xB16F17E5;
+
+struct bigFile_header {
+	uint32_t magic = BIGFILE_MAGIC;
+	uint32_t version;
+	uint32_t reserved[8] {}; // for future extension
+};
+inline BinaryStream& operator << (BinaryStream& stream, bigFile_header const& h) {
+	stream << h.magic << h.version;
+	for (int i=0; i<8; i++)
+		stream << h.reserved[i];
+	return stream;
+}
+inline BinaryStream& operator >> (BinaryStream& stream, bigFile_header &h) {
+	stream >> h.magic >> h.version;
+	for (int i=0; i<8; i++)
+		stream >> h.reserved[i];
+	return stream;
+}
+
+#endif /* SERIALIZATION_BIGFILE_HEADER_H_ */
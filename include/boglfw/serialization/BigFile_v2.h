@@ -0,0 +1,98 @@
+/*
+ * BigFile_v2.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef SERIALIZATION_BIGFILE_V2_H_
+#define SERIALIZATION_BIGFILE_V2_H_
+
+#include "BinaryStream.h"
+
+#include <cstdint>
+
+/*
+ * Layout of a version 2 BigFile (all values little endian, all offsets from the beginning of the file):
+ *
+ *	bigFile_header						(version = 2)
+ *	bigFile_tableHeader_v2				the offsets of the sections below
+ *	entry bodies						each starting at a multiple of the table header's alignment
+ *	bigFile_tableEntry_v2[numEntries]	8 byte aligned
+ *	uint32_t buckets[numBuckets]		open-addressing hash index: entry index + 1, or 0 for an empty bucket;
+ *										an entry is found by probing linearly from (nameHash & (numBuckets-1))
+ *	names								the entry names, each followed by a '\0'
+ *
+ * The table comes after the bodies so that the file can be written in one pass (see BigFileWriter); the table header
+ * is written last, so the file of an interrupted write is rejected when loading. Readers only go by the offsets in
+ * the table header, not by this order.
+ *
+ * An entry's flags hold the CompressionMethod of its body (bigFile_entryCompressionMask); the other bits must be 0.
+ * Compressed bodies are storedSize bytes long and decompress to size bytes.
+ *
+ * The table has a fixed layout, so a mapped file can be used in place, without parsing it.
+ */
+
+struct bigFile_tableHeader_v2 {
+	uint32_t numEntries;
+	uint32_t numBuckets;		// power of two
+	uint32_t alignment;			// of the entry bodies; power of two
+	uint32_t reserved0;
+	uint64_t entriesOffset;
+	uint64_t bucketsOffset;
+	uint64_t namesOffset;
+	uint64_t namesSize;
+	uint32_t reserved[8]; // for future extension
+};
+static_assert(sizeof(bigFile_tableHeader_v2) == 80, "bigFile_tableHeader_v2 layout must not change");
+
+inline BinaryStream& operator << (BinaryStream& stream, bigFile_tableHeader_v2 const& h) {
+	stream << h.numEntries << h.numBuckets << h.alignment << h.reserved0;
+	stream << h.entriesOffset << h.bucketsOffset << h.namesOffset << h.namesSize;
+	for (int i=0; i<8; i++)
+		stream << h.reserved[i];
+	return stream;
+}
+inline BinaryStream& operator >> (BinaryStream& stream, bigFile_tableHeader_v2 &h) {
+	stream >> h.numEntries >> h.numBuckets >> h.alignment >> h.reserved0;
+	stream >> h.entriesOffset >> h.bucketsOffset >> h.namesOffset >> h.namesSize;
+	for (int i=0; i<8; i++)
+		stream >> h.reserved[i];
+	return stream;
+}
+
+struct bigFile_tableEntry_v2 {
+	uint64_t offset;		// of the body
+	uint64_t size;			// of the contents
+	uint64_t storedSize;	// of the body in the file
+	uint64_t nameHash;		// bigFile_nameHash() of the name
+	uint32_t nameOffset;	// into the names section
+	uint32_t nameLength;	// without the '\0'
+	uint32_t flags;
+	uint32_t reserved;
+};
+static constexpr uint32_t bigFile_entryCompressionMask = 0xff;
+static_assert(sizeof(bigFile_tableEntry_v2) == 48, "bigFile_tableEntry_v2 layout must not change");
+
+inline BinaryStream& operator << (BinaryStream& stream, bigFile_tableEntry_v2 const& e) {
+	stream << e.offset << e.size << e.storedSize << e.nameHash;
+	stream << e.nameOffset << e.nameLength << e.flags << e.reserved;
+	return stream;
+}
+inline BinaryStream& operator >> (BinaryStream& stream, bigFile_tableEntry_v2 &e) {
+	stream >> e.offset >> e.size >> e.storedSize >> e.nameHash;
+	stream >> e.nameOffset >> e.nameLength >> e.flags >> e.reserved;
+	return stream;
+}
+
+// 64 bit FNV-1a
+inline uint64_t bigFile_nameHash(const char* name, size_t length) {
+	uint64_t h = 0xcbf29ce484222325ull;
+	for (size_t i=0; i<length; i++) {
+		h ^= (uint8_t)name[i];
+		h *= 0x100000001b3ull;
+	}
+	return h;
+}
+
+#endif /* SERIALIZATION_BIGFILE_V2_H_ */
@@ -42,7 +42,12 @@ public:
 	size_t size() const { return ifstream_ ? fileSize_ : size_; }
 	const void* getBuffer() const { assertDbg(!ifstream_); return buffer_; }
 	void seek(size_t offset);
+	size_t getPos() const { return pos_; }
 	bool eof() { return ifstream_ ? pos_ >= fileSize_ : pos_ >= size_; }
+	/**
+	 * empties a write stream so it can be filled again; the buffer is kept, so this doesn't allocate
+	 */
+	void clear();
 
 	/**
 	 * reads raw data from the stream and copies it into the supplied buffer.
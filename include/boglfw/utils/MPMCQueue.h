@@ -0,0 +1,171 @@
+/*
+ * MPMCQueue.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef UTILS_MPMCQUEUE_H_
+#define UTILS_MPMCQUEUE_H_
+
+/*
+ *  Bounded Multi-Producer Multi-Consumer lock-free queue
+ *
+ *  1. Any number of threads may push and pop concurrently; pushing and popping are lock-free.
+ *  2. The capacity is fixed at construction and rounded up to the next power of two.
+ *  	Unlike MTVector, there is no locking fallback when the queue is full: tryPush() fails, push() waits.
+ *  3. tryPush() / tryPop() never block; push() / pop() spin (yielding) until space / data is available.
+ *  4. Each cell carries a sequence number that tells producers and consumers whose turn it is, so the only
+ *  	contended atomics are the enqueue and dequeue positions, which live on separate cache lines.
+ *  5. destruction is NOT thread-safe
+ */
+
+#include "cacheLine.h"
+#include "assert.h"
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+
+template<class C>
+class MPMCQueue {
+public:
+	explicit MPMCQueue(size_t capacity)
+		: capacity_(roundUpPow2(capacity))
+		, mask_(capacity_ - 1)
+		, cells_(static_cast<cell*>(malloc(sizeof(cell) * capacity_)))
+	{
+		for (size_t i=0; i<capacity_; i++)
+			new(&cells_[i].sequence_) std::atomic<size_t>(i);
+	}
+
+	MPMCQueue(MPMCQueue const&) = delete;
+	MPMCQueue& operator = (MPMCQueue const&) = delete;
+
+	~MPMCQueue() {
+		for (auto i = dequeuePos_.load(); i != enqueuePos_.load(); i++)
+			cells_[i & mask_].value()->~C();
+		free(cells_);
+		cells_ = nullptr;
+	}
+
+	// thread safe - returns false if the queue is full
+	bool tryPush(C const& c) {
+		return insert(c);
+	}
+
+	// thread safe - returns false if the queue is full
+	bool tryPush(C &&c) {
+		return insert(std::move(c));
+	}
+
+	// thread safe - waits until there's room in the queue
+	void push(C const& c) {
+		while (!insert(c))
+			std::this_thread::yield();
+	}
+
+	// thread safe - waits until there's room in the queue
+	void push(C &&c) {
+		while (!insert(std::move(c)))
+			std::this_thread::yield();
+	}
+
+	// thread safe - returns false if the queue is empty
+	bool tryPop(C &out) {
+		cell* pCell;
+		auto pos = dequeuePos_.load(std::memory_order_relaxed);
+		while (true) {
+			pCell = &cells_[pos & mask_];
+			auto seq = pCell->sequence_.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+			if (diff == 0) {
+				if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			} else if (diff < 0)
+				return false;	// empty
+			else
+				pos = dequeuePos_.load(std::memory_order_relaxed);
+		}
+		out = std::move(*pCell->value());
+		pCell->value()->~C();
+		pCell->sequence_.store(pos + mask_ + 1, std::memory_order_release);
+		return true;
+	}
+
+	// thread safe - waits until an element is available
+	void pop(C &out) {
+		while (!tryPop(out))
+			std::this_thread::yield();
+	}
+
+	// thread safe-ish (may return non-up-to-date value if another thread is working on the queue)
+	size_t size() const {
+		auto enq = enqueuePos_.load(std::memory_order_acquire);
+		auto deq = dequeuePos_.load(std::memory_order_acquire);
+		return enq > deq ? enq - deq : 0;
+	}
+
+	// thread safe-ish (may return non-up-to-date value if another thread is working on the queue)
+	bool empty() const {
+		return size() == 0;
+	}
+
+	// thread safe
+	size_t capacity() const {
+		return capacity_;
+	}
+
+private:
+	struct cell {
+		std::atomic<size_t> sequence_;
+		typename std::aligned_storage<sizeof(C), alignof(C)>::type storage_;
+
+		C* value() { return reinterpret_cast<C*>(&storage_); }
+	};
+
+	const size_t capacity_;
+	const size_t mask_;
+	cell* cells_;
+	cacheLinePadding<cell*> pad0_;
+
+	std::atomic<size_t> enqueuePos_ { 0 };
+	cacheLinePadding<std::atomic<size_t>> pad1_;
+
+	std::atomic<size_t> dequeuePos_ { 0 };
+	cacheLinePadding<std::atomic<size_t>> pad2_;
+
+	static size_t roundUpPow2(size_t x) {
+		assertDbg(x > 0);
+		size_t p = 1;
+		while (p < x)
+			p <<= 1;
+		return p;
+	}
+
+	template<class ref>
+	bool insert(ref&& r) {
+		cell* pCell;
+		auto pos = enqueuePos_.load(std::memory_order_relaxed);
+		while (true) {
+			pCell = &cells_[pos & mask_];
+			auto seq = pCell->sequence_.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+			if (diff == 0) {
+				if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			} else if (diff < 0)
+				return false;	// full
+			else
+				pos = enqueuePos_.load(std::memory_order_relaxed);
+		}
+		new(pCell->value()) C(std::forward<ref>(r));
+		pCell->sequence_.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+};
+
+#endif /* UTILS_MPMCQUEUE_H_ */
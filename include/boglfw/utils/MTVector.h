@@ -23,6 +23,7 @@
 
 #include "../math/math3D.h"
 #include "log.h"
+#include "../perf/profiledMutex.h"
 #include <mutex>
 #include <atomic>
 #include <vector>
@@ -33,9 +34,12 @@ template<class C>
 class MTVector {
 public:
 
-	MTVector(size_t preallocatedCapacity)
+	// lockName is used for profiling the lock taken when the preallocated capacity is exceeded (see perf::ProfiledMutex);
+	// pass nullptr to disable the profiling for this instance
+	MTVector(size_t preallocatedCapacity, const char lockName[] = "MTVector::extraMtx_")
 		: capacity_(preallocatedCapacity)
 		, array_(static_cast<C*>(malloc(sizeof(C)*preallocatedCapacity)))
+		, extraMtx_(lockName)
 	{
 	}
 
@@ -46,6 +50,7 @@ public:
 		, array_(static_cast<C*>(malloc(sizeof(C)*capacity_)))
 		, insertPtr_(src.insertPtr_.load())
 		, extra_(src.extra_)
+		, extraMtx_(src.extraMtx_.getName())
 	{
 		for (size_t i=0; i<insertPtr_; i++) {
 			new (array_+i) C(src.array_[i]);
@@ -57,6 +62,7 @@ public:
 	MTVector(MTVector &&src)
 		: capacity_(0)
 		, array_(nullptr)
+		, extraMtx_(src.extraMtx_.getName())
 	{
 		operator =(std::move(src));
 	}
@@ -143,7 +149,7 @@ public:
 				std::memory_order_relaxed)) {
 			// nothing, just loop
 		}
-		std::lock_guard<std::mutex> lk(extraMtx_);
+		std::lock_guard<perf::ProfiledMutex> lk(extraMtx_);
 		std::copy(begin(), end(), std::back_inserter(out));
 		insertionsBlocked_.store(false, std::memory_order_release);
 	}
@@ -232,7 +238,7 @@ private:
 	std::atomic<size_t> insertPtr_ { 0 };
 	std::atomic<size_t> size_ { 0 };
 	std::vector<C> extra_;
-	std::mutex extraMtx_;
+	perf::ProfiledMutex extraMtx_;
 	std::atomic<bool> insertionsBlocked_ {false};
 
 	template<class ref>
@@ -246,8 +252,8 @@ private:
 		} else {
 			// preallocated space filled up, must lock on the extra vector
 			LOGPREFIX("MTVECTOR");
-			LOGLN("PERFORMANCE WARNING: preallocated capacity reached, performing LOCK !!! capacity:" << capacity_<< "   size:" << size_.load(std::memory_order_consume));
-			std::lock_guard<std::mutex> lk(extraMtx_);
+			LOGLN_EVERY_MS(1000, "PERFORMANCE WARNING: preallocated capacity reached, performing LOCK !!! capacity:" << capacity_<< "   size:" << size_.load(std::memory_order_consume));
+			std::lock_guard<perf::ProfiledMutex> lk(extraMtx_);
 			extra_.push_back(std::forward<ref>(r));
 			writeIndex = extra_.size() - 1 + capacity_;
 		}
@@ -0,0 +1,149 @@
+/*
+ * SPSCQueue.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef UTILS_SPSCQUEUE_H_
+#define UTILS_SPSCQUEUE_H_
+
+/*
+ *  Single-Producer Single-Consumer lock-free ring buffer
+ *
+ *  1. Exactly one thread may push and exactly one (other) thread may pop at the same time; anything else is undefined.
+ *  2. The capacity is fixed at construction and rounded up to the next power of two.
+ *  3. tryPush() / tryPop() never block; push() / pop() spin (yielding) until space / data is available.
+ *  4. Producer and consumer indices live on separate cache lines, and each side keeps a cached copy of the other
+ *  	side's index, so in the common case an operation touches only its own cache line.
+ *  5. destruction is NOT thread-safe
+ */
+
+#include "cacheLine.h"
+#include "assert.h"
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <new>
+#include <cstdlib>
+
+template<class C>
+class SPSCQueue {
+public:
+	explicit SPSCQueue(size_t capacity)
+		: capacity_(roundUpPow2(capacity))
+		, mask_(capacity_ - 1)
+		, array_(static_cast<C*>(malloc(sizeof(C) * capacity_)))
+	{
+	}
+
+	SPSCQueue(SPSCQueue const&) = delete;
+	SPSCQueue& operator = (SPSCQueue const&) = delete;
+
+	~SPSCQueue() {
+		for (auto i = readPtr_.load(); i != writePtr_.load(); i++)
+			array_[i & mask_].~C();
+		free(array_);
+		array_ = nullptr;
+	}
+
+	// producer only - returns false if the queue is full
+	bool tryPush(C const& c) {
+		return insert(c);
+	}
+
+	// producer only - returns false if the queue is full
+	bool tryPush(C &&c) {
+		return insert(std::move(c));
+	}
+
+	// producer only - waits until there's room in the queue
+	void push(C const& c) {
+		while (!insert(c))
+			std::this_thread::yield();
+	}
+
+	// producer only - waits until there's room in the queue
+	void push(C &&c) {
+		while (!insert(std::move(c)))
+			std::this_thread::yield();
+	}
+
+	// consumer only - returns false if the queue is empty
+	bool tryPop(C &out) {
+		auto readIndex = readPtr_.load(std::memory_order_relaxed);
+		if (readIndex == cachedWritePtr_) {
+			cachedWritePtr_ = writePtr_.load(std::memory_order_acquire);
+			if (readIndex == cachedWritePtr_)
+				return false;
+		}
+		C* slot = array_ + (readIndex & mask_);
+		out = std::move(*slot);
+		slot->~C();
+		readPtr_.store(readIndex + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer only - waits until an element is available
+	void pop(C &out) {
+		while (!tryPop(out))
+			std::this_thread::yield();
+	}
+
+	// thread safe-ish (may return non-up-to-date value if the other side is working on the queue)
+	size_t size() const {
+		// read first: it never passes write, so a consumer advancing in between can't make the difference wrap
+		size_t read = readPtr_.load(std::memory_order_acquire);
+		return writePtr_.load(std::memory_order_acquire) - read;
+	}
+
+	// thread safe-ish (may return non-up-to-date value if the other side is working on the queue)
+	bool empty() const {
+		return size() == 0;
+	}
+
+	// thread safe
+	size_t capacity() const {
+		return capacity_;
+	}
+
+private:
+	const size_t capacity_;
+	const size_t mask_;
+	C* array_;
+	cacheLinePadding<C*> pad0_;
+
+	// producer side:
+	std::atomic<size_t> writePtr_ { 0 };
+	size_t cachedReadPtr_ = 0;
+	cacheLinePadding<std::pair<std::atomic<size_t>, size_t>> pad1_;
+
+	// consumer side:
+	std::atomic<size_t> readPtr_ { 0 };
+	size_t cachedWritePtr_ = 0;
+	cacheLinePadding<std::pair<std::atomic<size_t>, size_t>> pad2_;
+
+	static size_t roundUpPow2(size_t x) {
+		assertDbg(x > 0);
+		size_t p = 1;
+		while (p < x)
+			p <<= 1;
+		return p;
+	}
+
+	template<class ref>
+	bool insert(ref&& r) {
+		auto writeIndex = writePtr_.load(std::memory_order_relaxed);
+		if (writeIndex - cachedReadPtr_ == capacity_) {
+			cachedReadPtr_ = readPtr_.load(std::memory_order_acquire);
+			if (writeIndex - cachedReadPtr_ == capacity_)
+				return false;
+		}
+		new(array_ + (writeIndex & mask_)) C(std::forward<ref>(r));
+		writePtr_.store(writeIndex + 1, std::memory_order_release);
+		return true;
+	}
+};
+
+#endif /* UTILS_SPSCQUEUE_H_ */
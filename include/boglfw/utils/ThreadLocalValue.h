@@ -8,19 +8,49 @@
 #ifndef THREAD_LOCAL_VALUE_H
 #define THREAD_LOCAL_VALUE_H
 
-#include <map>
+#include <vector>
+#include <cstdint>
+
+/*
+ *  Each ThreadLocalValue instance gets a slot index at construction; every thread keeps a dense array of values
+ *  indexed by slot, so get() and set() are a bounds check and an array access.
+ *
+ *  1. A thread's value is created (as a copy of the initial value) the first time that thread accesses it.
+ *  2. When a thread exits, all its values are destroyed.
+ *  3. When an instance is destroyed, the value of the destroying thread is destroyed immediately; values on other threads
+ *  	are destroyed when those threads exit or when they access the slot again after it's been reused by another instance.
+ */
 
 namespace ThreadLocalValuePrivate {
-	using vtype=char[12];
-	extern thread_local std::map<void*, vtype> mapThreadValues_;
+	struct entry {
+		void* value = nullptr;
+		void (*deleter)(void*) = nullptr;
+		uint64_t generation = 0;	// identifies the instance that created the value
+	};
+
+	struct threadEntries {
+		std::vector<entry> entries;
+
+		threadEntries();
+		~threadEntries();
+		void release(unsigned slot);
+	};
+
+	extern thread_local threadEntries threadValues_;
+	// true between the construction and destruction of this thread's threadValues_; a static ThreadLocalValue
+	// may be destroyed after the main thread's thread_locals, when threadValues_ must not be touched anymore
+	extern thread_local bool threadValuesAlive_;
+
+	// returns a free slot index and a unique generation number for a new instance
+	void allocSlot(unsigned &outSlot, uint64_t &outGeneration);
+	// returns the slot to the free list; values still held by other threads for it will be discarded on their next access
+	void freeSlot(unsigned slot);
 }
 
 template <class C>
 class ThreadLocalValue {
 public:
-	static_assert(sizeof(C) <= sizeof(ThreadLocalValuePrivate::vtype), "Not enough storage space for type!");
-
-	C get() const;
+	C get() const { return value(); }
 	void set(C value);
 
 	ThreadLocalValue& operator=(C val) {
@@ -35,34 +65,71 @@ public:
 	ThreadLocalValue();
 	ThreadLocalValue(C initial);
 	~ThreadLocalValue();
+
+	ThreadLocalValue(ThreadLocalValue const&) = delete;
+	ThreadLocalValue& operator=(ThreadLocalValue const&) = delete;
+
+private:
+	unsigned slot_;
+	uint64_t generation_;
+	C initial_;
+
+	C& value() const;
+	C& createValue(ThreadLocalValuePrivate::entry &e) const;
+
+	static void deleteValue(void* p) { delete static_cast<C*>(p); }
 };
 
 // ------------------------------------ IMPLEMENTATION ----------------------------------------------
 
 template <class C>
-ThreadLocalValue<C>::ThreadLocalValue() {
-	set({});
+ThreadLocalValue<C>::ThreadLocalValue()
+	: initial_{} {
+	ThreadLocalValuePrivate::allocSlot(slot_, generation_);
 }
 
 template <class C>
-ThreadLocalValue<C>::ThreadLocalValue(C initial) {
-	set(initial);
+ThreadLocalValue<C>::ThreadLocalValue(C initial)
+	: initial_(initial) {
+	ThreadLocalValuePrivate::allocSlot(slot_, generation_);
 }
 
 template <class C>
 ThreadLocalValue<C>::~ThreadLocalValue() {
-	ThreadLocalValuePrivate::mapThreadValues_.erase((void*)this);
+	// if this thread has no values (anymore), there's nothing of ours to release
+	if (ThreadLocalValuePrivate::threadValuesAlive_) {
+		auto &entries = ThreadLocalValuePrivate::threadValues_.entries;
+		if (slot_ < entries.size() && entries[slot_].generation == generation_)
+			ThreadLocalValuePrivate::threadValues_.release(slot_);
+	}
+	ThreadLocalValuePrivate::freeSlot(slot_);
+}
+
+template <class C>
+C& ThreadLocalValue<C>::value() const {
+	auto &entries = ThreadLocalValuePrivate::threadValues_.entries;
+	if (slot_ >= entries.size())
+		entries.resize(slot_ + 1);
+	auto &e = entries[slot_];
+	if (e.generation != generation_)
+		return createValue(e);
+	return *static_cast<C*>(e.value);
 }
 
 template <class C>
-C ThreadLocalValue<C>::get() const {
-	auto &val = ThreadLocalValuePrivate::mapThreadValues_[(void*)this];
-	return *((C*)&val);
+C& ThreadLocalValue<C>::createValue(ThreadLocalValuePrivate::entry &e) const {
+	// the slot may still hold a value left behind by a previous (destroyed) instance
+	if (e.value)
+		e.deleter(e.value);
+	e.value = new C(initial_);
+	e.deleter = &deleteValue;
+	e.generation = generation_;
+	return *static_cast<C*>(e.value);
 }
 
 template <class C>
 void ThreadLocalValue<C>::set(C value) {
-	*((C*)&ThreadLocalValuePrivate::mapThreadValues_[(void*)this]) = value;
+	this->value() = value;
 }
 
 #endif // THREAD_LOCAL_VALUE_H
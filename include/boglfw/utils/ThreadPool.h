@@ -15,6 +15,12 @@
 #include <vector>
 #include <atomic>
 #include <thread>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+
+#include "cacheLine.h"
+#include "../perf/profiledMutex.h"
 
 //#define DEBUG_THREADPOOL	// to enable debug logs
 
@@ -32,6 +38,7 @@ private:
 	std::atomic<bool> started_ { false };
 	std::atomic<bool> finished_ { false };
 	std::function<void()> workFunc_;
+	std::chrono::high_resolution_clock::time_point queuedTime_;	// only set while instrumentation is enabled
 
 	friend class ThreadPool;
 	PoolTask(decltype(workFunc_) func)
@@ -40,9 +47,42 @@ private:
 };
 using PoolTaskHandle = std::shared_ptr<PoolTask>;
 
+// controls where the workers of a ThreadPool are allowed to run
+struct ThreadPoolAffinity {
+	enum Mode {
+		Floating,		// workers may run on any CPU (OS decides)
+		PinEachWorker,	// worker i is pinned to cpus[i % cpus.size()]
+		RestrictToCpus,	// all workers may run on any of the given cpus (use this to build one pool per package)
+	};
+	Mode mode = Floating;
+	std::vector<unsigned> cpus;		// logical CPU indexes; empty means all CPUs from CpuTopology, in topology order
+	bool numaLocalQueues = false;	// keep a separate task queue for each NUMA node the workers are pinned on (PinEachWorker only)
+};
+
 class ThreadPool {
 public:
-	ThreadPool(unsigned numberOfThreads);
+	// bucket i of the wait histogram counts tasks that waited in [2^i, 2^(i+1)) nanoseconds before starting
+	static constexpr unsigned waitHistogramBuckets = 40;
+
+	struct WorkerStats {
+		uint64_t busyNanosec = 0;	// time spent executing tasks
+		uint64_t idleNanosec = 0;	// time spent waiting for tasks (including pool mutex contention)
+		uint64_t tasksExecuted = 0;
+		uint64_t tasksStolen = 0;	// tasks taken from another NUMA node's queue
+		uint64_t waitHistogram[waitHistogramBuckets] {0};	// task wait-to-start latency
+	};
+
+	struct Stats {
+		std::vector<WorkerStats> workers;
+		uint64_t queueDepthSamples = 0;	// one sample is taken each time a task is queued
+		uint64_t queueDepthSum = 0;
+		uint64_t queueDepthMax = 0;
+	};
+
+	// value for queueTaskOnNode() meaning the task can be executed by any worker
+	static constexpr unsigned anyNode = ~0u;
+
+	ThreadPool(unsigned numberOfThreads, ThreadPoolAffinity const& affinity = ThreadPoolAffinity());
 	~ThreadPool();	// make sure you call stop() before destruction
 
 	void stop(); // waits for all tasks to finish processing, waits for all workers to finish and shuts down the threads in the pool
@@ -51,7 +91,14 @@ public:
 
 	template<class F, class... Args>
 	PoolTaskHandle queueTask(F task, Args... args) {
-		std::unique_lock<std::mutex> lk(poolMutex_);
+		return queueTaskOnNode(anyNode, task, args...);
+	}
+
+	// queues a task preferably executed by a worker on the given NUMA node (index between 0 and getNumaNodeCount()-1).
+	// workers on other nodes only pick it up when they have nothing else to do.
+	template<class F, class... Args>
+	PoolTaskHandle queueTaskOnNode(unsigned node, F task, Args... args) {
+		std::unique_lock<perf::ProfiledMutex> lk(poolMutex_);
 		while (queueBlocked_.load(std::memory_order_acquire)) {
 			lk.unlock();
 			std::this_thread::yield();
@@ -62,7 +109,13 @@ public:
 #endif
 		checkValidState();
 		auto handle = std::shared_ptr<PoolTask>(new PoolTask([=] () mutable { task(args...); }));
-		queuedTasks_.push(handle);
+		if (node < nodeQueues_.size())
+			nodeQueues_[node].push(handle);
+		else
+			queuedTasks_.push(handle);
+		pendingTasks_++;
+		if (instrumentationEnabled_.load(std::memory_order_relaxed))
+			recordQueuedTask(*handle);
 		//lk.unlock(); -- TODO unlocking the mutex here causes the notify_one() below to sometimes hang
 #ifdef DEBUG_THREADPOOL
 	LOGLN(__FUNCTION__ << " mutex unlocked. notifying...");
@@ -75,21 +128,55 @@ public:
 	}
 
 	unsigned getThreadCount() const { return workers_.size(); }
+	// number of NUMA nodes with separate task queues (1 unless the pool was created with numaLocalQueues)
+	unsigned getNumaNodeCount() const { return std::max<size_t>(1, nodeQueues_.size()); }
+	unsigned getThreadCountOnNode(unsigned node) const;
+
+	// enables or disables collection of the statistics below; while disabled the overhead is one relaxed atomic load per task.
+	void setInstrumentationEnabled(bool enabled) { instrumentationEnabled_.store(enabled, std::memory_order_relaxed); }
+	bool isInstrumentationEnabled() const { return instrumentationEnabled_.load(std::memory_order_relaxed); }
+	// returns the statistics accumulated since construction or the last resetStats()
+	Stats getStats();
+	void resetStats();
 
 protected:
+	struct workerCounters {
+		std::atomic<uint64_t> busyNanosec { 0 };
+		std::atomic<uint64_t> idleNanosec { 0 };
+		std::atomic<uint64_t> tasksExecuted { 0 };
+		std::atomic<uint64_t> tasksStolen { 0 };
+		std::atomic<uint64_t> waitHistogram[waitHistogramBuckets];
+		cacheLinePadding<uint64_t> pad_;
+
+		workerCounters() { for (auto &b : waitHistogram) b.store(0, std::memory_order_relaxed); }
+	};
+
+
 	std::queue<PoolTaskHandle> queuedTasks_;
-	std::mutex poolMutex_;
-	std::condition_variable condPendingTask_;
+	std::vector<std::queue<PoolTaskHandle>> nodeQueues_;	// one per NUMA node, only with numaLocalQueues
+	std::vector<unsigned> workerNode_;	// index into nodeQueues_ for each worker
+	unsigned pendingTasks_ = 0;			// tasks in all queues
+	perf::ProfiledMutex poolMutex_ { "ThreadPool::poolMutex_" };
+	std::condition_variable_any condPendingTask_;	// _any because poolMutex_ is not a std::mutex
 	std::vector<std::thread> workers_;
 	std::atomic<bool> queueBlocked_ { false };	// pool is waiting for all tasks completion, calls to queueTask are blocked until operation finishes
 	std::atomic<bool> stopSignal_ { false };	// signal workers to stop
 	std::atomic<bool> stopRequested_ { false };	// stop requested by user
 	std::atomic<bool> stopped_ { false };
-
-	void workerFunc();
+	std::atomic<bool> instrumentationEnabled_ { false };
+	std::unique_ptr<workerCounters[]> workerCounters_;
+	// queue depth samples are guarded by poolMutex_
+	uint64_t queueDepthSamples_ = 0;
+	uint64_t queueDepthSum_ = 0;
+	uint64_t queueDepthMax_ = 0;
+
+	void workerFunc(unsigned workerIndex);
+	void recordQueuedTask(PoolTask &task);	// must be called with poolMutex_ held
+	PoolTaskHandle popTask(unsigned workerIndex, bool &outStolen);	// must be called with poolMutex_ held
+	void setupAffinity(ThreadPoolAffinity const& affinity);
 
 	void checkValidState();
-	void wait_impl(std::unique_lock<std::mutex> &lk);
+	void wait_impl(std::unique_lock<perf::ProfiledMutex> &lk);
 };
 
 
@@ -0,0 +1,74 @@
+/*
+ * asyncLogger.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef UTILS_ASYNCLOGGER_H_
+#define UTILS_ASYNCLOGGER_H_
+
+#include <cstdint>
+#include <cstddef>
+
+struct AsyncLoggerConfig {
+	enum OverflowPolicy {
+		Drop,		// lines that don't fit in the thread's buffer are dropped (and counted)
+		Block,		// the logging thread waits for the writer to make room
+	};
+
+	// size in bytes of each thread's ring buffer
+	size_t threadBufferSize = 256 * 1024;
+	// what happens when a thread logs faster than the writer can keep up; ERRORs are never dropped -
+	// if they don't fit they are written synchronously, and in any case ERROR waits until its line is written
+	OverflowPolicy overflowPolicy = Drop;
+	// how often the writer thread wakes up to drain the buffers
+	unsigned flushIntervalMs = 10;
+	// records newer than this are held back for the next flush, so that lines from different threads that were
+	// timestamped close together are still written in order
+	unsigned reorderWindowMs = 2;
+};
+
+/*
+ * Background writer for the LOG / ERROR macros.
+ * While running, each thread formats its lines into a thread-local buffer (without taking any lock) and pushes them
+ * into its own lock-free ring buffer, together with a timestamp. A single writer thread periodically drains all
+ * the ring buffers, sorts the records by timestamp and writes them to the logger's streams.
+ * The output has the same format as in synchronous mode, except that the time in the prefix is the time the line
+ * was logged, not the time it was written.
+ * When not running (the default) the macros write synchronously under logger's mutexes.
+ */
+class AsyncLogger {
+public:
+	// starts the writer thread; the config applies to the buffers of threads that haven't logged yet
+	static void start(AsyncLoggerConfig const& config = {});
+	// writes out everything that was logged and stops the writer thread; the macros go back to synchronous mode.
+	// Infrastructure::shutDown() calls this, otherwise call it before exiting.
+	static void stop();
+	static bool isRunning();
+
+	// blocks until everything logged before the call has been written to the streams
+	static void flush();
+
+	// the number of lines dropped because a thread's buffer was full, since the start
+	static uint64_t getDroppedCount();
+
+	enum RecordKind : uint16_t {
+		LogRecord,		// goes to the log stream
+		StdoutRecord,	// goes to std::cout (the DEBUG-build copy of LOG lines)
+		ErrorRecord,	// goes to std::cerr and the additional error stream
+	};
+	enum RecordFlags : uint16_t {
+		NoPrefix = 1,	// the line doesn't get the timestamp (LOGNP)
+		Deferred = 2,	// the text is a LOGF record, formatted by the writer (see logFormat.h)
+	};
+
+	// used by the logger; returns false if the line couldn't be queued, in which case the caller must write it synchronously.
+	// Error records are written out before this returns.
+	static bool write(RecordKind kind, uint16_t flags, const char* text, size_t length);
+
+private:
+	static bool push(RecordKind kind, uint16_t flags, const char* text, size_t length);
+};
+
+#endif /* UTILS_ASYNCLOGGER_H_ */
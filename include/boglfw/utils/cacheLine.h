@@ -0,0 +1,23 @@
+/*
+ * cacheLine.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef UTILS_CACHELINE_H_
+#define UTILS_CACHELINE_H_
+
+#include <cstddef>
+
+// size of a CPU cache line on all the platforms we care about (x86-64 and most ARM cores)
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+// padding to insert after a member of type T in order to push the next member onto a different cache line.
+// use this to keep data written by different threads from sharing a cache line (false sharing).
+template<class T>
+struct cacheLinePadding {
+	char pad_[sizeof(T) < CACHE_LINE_SIZE ? CACHE_LINE_SIZE - sizeof(T) : CACHE_LINE_SIZE];
+};
+
+#endif /* UTILS_CACHELINE_H_ */
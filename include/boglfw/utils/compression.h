@@ -0,0 +1,48 @@
+/*
+ * compression.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef UTILS_COMPRESSION_H_
+#define UTILS_COMPRESSION_H_
+
+#include <cstdint>
+#include <cstddef>
+
+// the values are stored in files, don't change them
+enum class CompressionMethod : uint8_t {
+	None	= 0,
+	FastLZ	= 1,	// built-in LZ77 compressor, always available; fast, with a lower ratio than the others
+	LZ4		= 2,	// only available when built WITH_LZ4
+	Zstd	= 3,	// only available when built WITH_ZSTD
+};
+
+/*
+ * One-shot compression of memory blocks. The compressed blocks carry no header: the caller must store the method
+ * and the decompressed size alongside them.
+ * All functions are thread safe.
+ */
+class Compression {
+public:
+	static bool isAvailable(CompressionMethod method);
+	// the method with the best ratio among the available ones (Zstd, then LZ4, then FastLZ)
+	static CompressionMethod getPreferred();
+	static const char* getName(CompressionMethod method);
+
+	// the output buffer size for which compress() never fails
+	static size_t maxCompressedSize(CompressionMethod method, size_t size);
+
+	// returns the compressed size, or 0 if the method isn't available or the output doesn't fit into dstCapacity.
+	// Pass a dstCapacity smaller than srcSize to give up early on incompressible data.
+	// level only applies to Zstd (0 means its default level)
+	static size_t compress(CompressionMethod method, const void* src, size_t srcSize, void* dst, size_t dstCapacity,
+			int level = 0);
+
+	// dstSize must be the exact decompressed size; returns false (without logging) if the input is corrupted
+	// or the method isn't available
+	static bool decompress(CompressionMethod method, const void* src, size_t srcSize, void* dst, size_t dstSize);
+};
+
+#endif /* UTILS_COMPRESSION_H_ */
@@ -0,0 +1,56 @@
+/*
+ * cpuTopology.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef UTILS_CPUTOPOLOGY_H_
+#define UTILS_CPUTOPOLOGY_H_
+
+#include <vector>
+#include <thread>
+
+/*
+ * Describes the logical CPUs of the machine, their physical cores, packages (sockets) and NUMA nodes.
+ * On Linux this is discovered from /sys/devices/system; elsewhere (or if /sys is unavailable) all the CPUs reported
+ * by std::thread::hardware_concurrency() are assumed to be on a single package and NUMA node.
+ */
+class CpuTopology {
+public:
+	struct CpuInfo {
+		unsigned cpu;		// logical CPU index as used by the OS
+		unsigned core;		// physical core id (unique within the package)
+		unsigned package;	// physical package (socket) id
+		unsigned numaNode;
+	};
+
+	// returns the topology of this machine, discovered on first use
+	static CpuTopology const& get();
+
+	// all online CPUs, ordered by NUMA node, package, core and logical index
+	std::vector<CpuInfo> const& getCpus() const { return cpus_; }
+	unsigned getPackageCount() const { return packages_.size(); }
+	unsigned getNumaNodeCount() const { return numaNodes_.size(); }
+	// package and node ids are not necessarily contiguous; these return the ids present on this machine
+	std::vector<unsigned> const& getPackageIds() const { return packages_; }
+	std::vector<unsigned> const& getNumaNodeIds() const { return numaNodes_; }
+
+	std::vector<unsigned> getCpusOnPackage(unsigned package) const;
+	std::vector<unsigned> getCpusOnNumaNode(unsigned node) const;
+	// returns the NUMA node of a logical CPU, or 0 if the CPU is unknown
+	unsigned getNumaNodeOfCpu(unsigned cpu) const;
+
+	// restricts the thread to run only on the given logical CPUs; returns false if not supported or if it failed
+	static bool setThreadAffinity(std::thread &thread, std::vector<unsigned> const& cpus);
+	static bool setCurrentThreadAffinity(std::vector<unsigned> const& cpus);
+
+private:
+	CpuTopology();
+
+	std::vector<CpuInfo> cpus_;
+	std::vector<unsigned> packages_;
+	std::vector<unsigned> numaNodes_;
+};
+
+#endif /* UTILS_CPUTOPOLOGY_H_ */
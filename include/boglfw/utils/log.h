@@ -13,64 +13,172 @@
 #ifdef _ENABLE_LOGGING_
 
 #include <iostream>
-#include <deque>
 #include <ostream>
 #include <string>
 #include <mutex>
 #include <atomic>
+#include <vector>
+#include <streambuf>
+#include <ctime>
+#include <limits>
+
+#include "../perf/profiledMutex.h"
+#include "../perf/clock.h"
+#include "asyncLogger.h"
+#include "logFormat.h"
 
 #define LOGPREFIX(PREF) logger_prefix logger_prefix_token(PREF);
 
+// in asynchronous mode (see asyncLogger.h) the line is formatted into a thread-local buffer and handed to the writer thread
 #define LOGIMPL(LEVEL, WRITE_PREFIX, X) {\
 	if (LEVEL <= logger::instance().getLogLevel()) {\
 		if (logger::instance().getLogStream()) {\
-			std::lock_guard<std::mutex> lk(logger::getLogMutex());\
-			if (WRITE_PREFIX)\
-				logger::instance().writeprefix(*logger::instance().getLogStream());\
-			*logger::instance().getLogStream() << X;\
+			if (logger::isAsync()) {\
+				logger::instance().beginLine(WRITE_PREFIX) << X;\
+				logger::instance().endLine(AsyncLogger::LogRecord, WRITE_PREFIX);\
+			} else {\
+				std::lock_guard<perf::ProfiledMutex> lk(logger::getLogMutex());\
+				if (WRITE_PREFIX)\
+					logger::instance().writeprefix(*logger::instance().getLogStream());\
+				*logger::instance().getLogStream() << X;\
+			}\
 		}\
 	}\
 }
 
+/*
+ * Deferred-format logging for hot paths: LOGF("loaded {} meshes in {} ms", count, time) logs a whole line.
+ * Only the argument values are copied on the calling thread, the text is produced by AsyncLogger's writer thread
+ * (see logFormat.h). The format must be a string literal.
+ */
+#define LOGFIMPL(LEVEL, KIND, FMT, ...) {\
+	if (LEVEL <= logger::instance().getLogLevel()) {\
+		static const logFormat logFormat_desc { FMT "\n" };\
+		logger::instance().logDeferred(KIND, logFormat_desc, ##__VA_ARGS__);\
+	}\
+}
+
+/*
+ * Lines above this level are removed at compile time (0: only errors, 1: also LOG, 2: also DEBUGLOG);
+ * the runtime level (logger::setLogLevel()) can only restrict further.
+ */
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 2
+#endif
+
+#if LOG_COMPILE_LEVEL >= 1
+
 #ifdef DEBUG
 #define LOG(X) { LOGIMPL(LOG_LEVEL_INFO, true, X)\
 	/* also put the log on stdout in DEBUG mode */\
 	if (LOG_LEVEL_INFO <= logger::instance().getLogLevel() && logger::instance().getLogStream() != &std::cout) {\
-		std::lock(logger::getLogMutex(), logger::getErrMutex());\
-		std::lock_guard<std::mutex> lkL(logger::getLogMutex(), std::adopt_lock);\
-		std::lock_guard<std::mutex> lkE(logger::getErrMutex(), std::adopt_lock);\
-		logger::instance().writeprefix(std::cout);\
-		std::cout << X;\
+		if (logger::isAsync()) {\
+			logger::instance().beginLine(true) << X;\
+			logger::instance().endLine(AsyncLogger::StdoutRecord, true);\
+		} else {\
+			std::lock(logger::getLogMutex(), logger::getErrMutex());\
+			std::lock_guard<perf::ProfiledMutex> lkL(logger::getLogMutex(), std::adopt_lock);\
+			std::lock_guard<perf::ProfiledMutex> lkE(logger::getErrMutex(), std::adopt_lock);\
+			logger::instance().writeprefix(std::cout);\
+			std::cout << X;\
+		}\
 	}\
 }
 #else
 #define LOG(X) LOGIMPL(LOG_LEVEL_INFO, true, X)
 #endif
 
+#ifdef DEBUG
+#define LOGF(FMT, ...) { LOGFIMPL(LOG_LEVEL_INFO, AsyncLogger::LogRecord, FMT, ##__VA_ARGS__)\
+	/* also put the log on stdout in DEBUG mode */\
+	if (logger::instance().getLogStream() != &std::cout)\
+		LOGFIMPL(LOG_LEVEL_INFO, AsyncLogger::StdoutRecord, FMT, ##__VA_ARGS__)\
+}
+#else
+#define LOGF(FMT, ...) LOGFIMPL(LOG_LEVEL_INFO, AsyncLogger::LogRecord, FMT, ##__VA_ARGS__)
+#endif
+
 #define LOGNP(X) LOGIMPL(LOG_LEVEL_INFO, false, X)
 #define LOGLN(X) LOG(X << "\n")
+
+// logs at most once every MS milliseconds from this call site; the next line that gets through
+// tells how many were suppressed in between
+#define LOGLN_EVERY_MS(MS, X) {\
+	static logRateLimit logRateLimit_site;\
+	uint32_t logRateLimit_suppressed;\
+	if (logRateLimit_site.allow(MS, logRateLimit_suppressed)) {\
+		if (logRateLimit_suppressed)\
+			LOGLN(X << " (" << logRateLimit_suppressed << " similar lines suppressed)")\
+		else\
+			LOGLN(X)\
+	}\
+}
+// logs only the first time this call site is reached
+#define LOGLN_ONCE(X) {\
+	static std::atomic<bool> logOnce_done { false };\
+	if (!logOnce_done.load(std::memory_order_relaxed) && !logOnce_done.exchange(true))\
+		LOGLN(X)\
+}
+
+#else
+#define LOG(X)
+#define LOGF(FMT, ...)
+#define LOGNP(X)
+#define LOGLN(X)
+#define LOGLN_EVERY_MS(MS, X)
+#define LOGLN_ONCE(X)
+#endif // LOG_COMPILE_LEVEL >= 1
+
 #define ERROR(X) {\
-	std::lock_guard<std::mutex> lk(logger::getErrMutex());\
-	for (auto stream : {&std::cerr, logger::instance().getErrStream()}) {\
-		if (!stream)\
-			continue;\
-		*stream << "!!!ERROR!!!";\
-		logger::instance().writeprefix(*stream);\
-		*stream << X << "\n";\
+	if (logger::isAsync()) {\
+		logger::instance().beginLine(true) << X << "\n";\
+		logger::instance().endLine(AsyncLogger::ErrorRecord, true);\
+	} else {\
+		std::lock_guard<perf::ProfiledMutex> lk(logger::getErrMutex());\
+		for (auto stream : {&std::cerr, logger::instance().getErrStream()}) {\
+			if (!stream)\
+				continue;\
+			*stream << "!!!ERROR!!!";\
+			logger::instance().writeprefix(*stream);\
+			*stream << X << "\n";\
+		}\
+	}\
+}
+#define ERROR_EVERY_MS(MS, X) {\
+	static logRateLimit logRateLimit_site;\
+	uint32_t logRateLimit_suppressed;\
+	if (logRateLimit_site.allow(MS, logRateLimit_suppressed)) {\
+		if (logRateLimit_suppressed)\
+			ERROR(X << " (" << logRateLimit_suppressed << " similar errors suppressed)")\
+		else\
+			ERROR(X)\
 	}\
 }
 
 #else
 #define LOGIMPL(LEVEL, WRITE_PREFIX, X)
+#define LOGFIMPL(LEVEL, KIND, FMT, ...)
 #define LOG(X)
+#define LOGF(FMT, ...)
 #define LOGNP(X)
 #define LOGLN(X)
+#define LOGLN_EVERY_MS(MS, X)
+#define LOGLN_ONCE(X)
 #define ERROR(X)
+#define ERROR_EVERY_MS(MS, X)
 #endif
 
+#if !defined(_ENABLE_LOGGING_) || LOG_COMPILE_LEVEL >= 2
 #define DEBUGLOG(X) LOGIMPL(LOG_LEVEL_DEBUG, true, X)
 #define DEBUGLOGNP(X) LOGIMPL(LOG_LEVEL_DEBUG, false, X)
 #define DEBUGLOGLN(X) DEBUGLOG(X << "\n")
+#define DEBUGLOGF(FMT, ...) LOGFIMPL(LOG_LEVEL_DEBUG, AsyncLogger::LogRecord, FMT, ##__VA_ARGS__)
+#else
+#define DEBUGLOG(X)
+#define DEBUGLOGNP(X)
+#define DEBUGLOGLN(X)
+#define DEBUGLOGF(FMT, ...)
+#endif
 
 #ifdef _ENABLE_LOGGING_
 
@@ -80,20 +188,67 @@ enum logLevels {
 	LOG_LEVEL_DEBUG
 };
 
+// growable output buffer for formatting one line at a time; keeps its memory between lines
+class logLineBuffer : public std::streambuf {
+public:
+	void clear() { setp(buf_.data(), buf_.data() + buf_.size()); }
+	const char* data() const { return pbase(); }
+	size_t length() const { return pptr() - pbase(); }
+
+protected:
+	int_type overflow(int_type c) override;
+	std::streamsize xsputn(const char* s, std::streamsize n) override;
+
+private:
+	std::vector<char> buf_;
+
+	void grow(size_t extra);
+};
+
 class logger {
 public:
+	// writes the timestamp and the logger name
 	void writeprefix(std::ostream &stream);
+	// writes only the logger name ("[a::b] ")
+	void writeNames(std::ostream &stream);
+	static void writeTimestamp(std::ostream &stream, time_t t);
+
+	// true while AsyncLogger is running
+	static bool isAsync() { return async_.load(std::memory_order_relaxed); }
+	// asynchronous mode: starts a new line in this thread's line buffer
+	std::ostream& beginLine(bool writePrefix) {
+		lineBuf_.clear();
+		if (writePrefix && prefixDepth_)
+			writeNames(lineStream_);
+		return lineStream_;
+	}
+	// asynchronous mode: hands the line over to the writer thread (or writes it directly if that's not possible)
+	void endLine(AsyncLogger::RecordKind kind, bool writePrefix) {
+		endRecord(kind, writePrefix ? 0 : AsyncLogger::NoPrefix);
+	}
+
+	// LOGF: encodes the arguments into this thread's line buffer; formatted when written out
+	template<class... Args>
+	void logDeferred(AsyncLogger::RecordKind kind, logFormat const& fmt, Args const&... args) {
+		if (kind == AsyncLogger::LogRecord && !getLogStream())
+			return;
+		lineBuf_.clear();
+		logArgs::encodeAll(lineBuf_, fmt, args...);
+		if (prefixDepth_)
+			writeNames(lineStream_);
+		endRecord(kind, AsyncLogger::Deferred);
+	}
 
 	// returns old stream
 	static std::ostream* setLogStream(std::ostream* newStream) {
-		std::lock_guard<std::mutex> lk(logMutex_);
+		std::lock_guard<perf::ProfiledMutex> lk(logMutex_);
 		std::ostream* pOld = instance_.pLogStream_;
 		instance_.pLogStream_.store(newStream);
 		return pOld;
 	}
 	// returns old stream
 	std::ostream* setAdditionalErrStream(std::ostream* newStream) {
-		std::lock_guard<std::mutex> lk(errMutex_);
+		std::lock_guard<perf::ProfiledMutex> lk(errMutex_);
 		std::ostream* pOld = instance_.pErrStream_;
 		instance_.pErrStream_.store(newStream);
 		return pOld;
@@ -104,8 +259,8 @@ public:
 
 	static logger& instance() { return instance_; }
 
-	static std::mutex& getLogMutex() { return logMutex_; }
-	static std::mutex& getErrMutex() { return errMutex_; }
+	static perf::ProfiledMutex& getLogMutex() { return logMutex_; }
+	static perf::ProfiledMutex& getErrMutex() { return errMutex_; }
 
 	static int getLogLevel() { return logLevel_.load(std::memory_order_acquire); }
 	static void setLogLevel(int level) { logLevel_.store(level, std::memory_order_release); }
@@ -113,21 +268,34 @@ public:
 private:
 	static std::atomic<std::ostream*> pLogStream_;
 	static std::atomic<std::ostream*> pErrStream_;
-	std::deque<std::string> prefix_;
+	static constexpr unsigned maxPrefixDepth = 16;
+	const char* prefix_[maxPrefixDepth];
+	unsigned prefixDepth_ = 0;		// may be larger than maxPrefixDepth, the deeper names are not shown
 	static thread_local logger& instance_;
-	static std::mutex logMutex_;
-	static std::mutex errMutex_;
+	static perf::ProfiledMutex logMutex_;
+	static perf::ProfiledMutex errMutex_;
 	static std::atomic_int logLevel_;
+	static std::atomic<bool> async_;
+	logLineBuffer lineBuf_;
+	std::ostream lineStream_ { &lineBuf_ };
 
-	void push_prefix(std::string prefix) { prefix_.push_back(prefix); }
-	void pop_prefix() { prefix_.pop_back(); }
+	void endRecord(AsyncLogger::RecordKind kind, uint16_t flags);
+
+	void push_prefix(const char* prefix) {
+		if (prefixDepth_ < maxPrefixDepth)
+			prefix_[prefixDepth_] = prefix;
+		prefixDepth_++;
+	}
+	void pop_prefix() { prefixDepth_--; }
 
 	friend class logger_prefix;
+	friend class AsyncLogger;
 };
 
+// the name must stay valid while the logger_prefix is alive (normally it's a string literal)
 class logger_prefix {
 public:
-	logger_prefix(std::string s) {
+	logger_prefix(const char* s) {
 		logger::instance_.push_prefix(s);
 	}
 	~logger_prefix() {
@@ -135,6 +303,28 @@ public:
 	}
 };
 
+// call site state of LOGLN_EVERY_MS / ERROR_EVERY_MS
+class logRateLimit {
+public:
+	constexpr logRateLimit() = default;
+
+	// returns true if a line may be logged now; suppressed receives the number of lines refused since the last one
+	bool allow(int64_t intervalMs, uint32_t &suppressed) {
+		int64_t now = perf::Clock::now().time_since_epoch().count();
+		int64_t next = nextTime_.load(std::memory_order_relaxed);
+		if (now < next || !nextTime_.compare_exchange_strong(next, now + intervalMs * 1000000, std::memory_order_relaxed)) {
+			suppressed_.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+		return true;
+	}
+
+private:
+	std::atomic<int64_t> nextTime_ { std::numeric_limits<int64_t>::min() };
+	std::atomic<uint32_t> suppressed_ { 0 };
+};
+
 #endif // _ENABLE_LOGGING_
 
 #define NOT_IMPLEMENTED throw std::runtime_error(std::string("Not implemented: ") + __PRETTY_FUNCTION__ + " : " + std::to_string(__LINE__))
@@ -0,0 +1,112 @@
+/*
+ * logFormat.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef UTILS_LOGFORMAT_H_
+#define UTILS_LOGFORMAT_H_
+
+/*
+ * Binary encoding of the LOGF / DEBUGLOGF lines (see log.h).
+ * The calling thread only copies the raw argument values next to a pointer to the call site's static format
+ * descriptor; the text is produced later by formatDeferred(), on AsyncLogger's writer thread (or immediately,
+ * under the log mutex, when the logger is synchronous).
+ *
+ * Record layout: [const logFormat*] [uint8 argCount] {[uint8 argType] [value]}... [logger names text]
+ * Strings are stored as [uint32 length] [chars]. Arguments of other types are formatted with operator<<
+ * on the calling thread and stored as strings, so they work but don't get the speed benefit.
+ */
+
+#include <streambuf>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+
+// the static part of a LOGF line; every "{}" in the format is replaced by the next argument
+struct logFormat {
+	const char* format;
+};
+
+namespace logArgs {
+
+enum argType : uint8_t {
+	Int,		// int64_t
+	UInt,		// uint64_t
+	Double,
+	Bool,
+	Char,
+	String,		// uint32_t length followed by the chars
+	Pointer,	// const void*
+};
+
+constexpr unsigned maxArgs = 16;
+
+template<class T>
+inline void putRaw(std::streambuf &buf, T const& value) {
+	buf.sputn(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+inline void putString(std::streambuf &buf, const char* s, size_t length) {
+	buf.sputc(String);
+	putRaw(buf, (uint32_t)length);
+	buf.sputn(s, length);
+}
+
+inline void encode(std::streambuf &buf, bool b)					{ buf.sputc(Bool); buf.sputc(b); }
+inline void encode(std::streambuf &buf, char c)					{ buf.sputc(Char); buf.sputc(c); }
+// ostream prints these as characters too, not as numbers
+inline void encode(std::streambuf &buf, signed char c)			{ encode(buf, (char)c); }
+inline void encode(std::streambuf &buf, unsigned char c)		{ encode(buf, (char)c); }
+inline void encode(std::streambuf &buf, float f)				{ buf.sputc(Double); putRaw(buf, (double)f); }
+inline void encode(std::streambuf &buf, double d)				{ buf.sputc(Double); putRaw(buf, d); }
+inline void encode(std::streambuf &buf, const char* s)			{ if (s) putString(buf, s, strlen(s)); else putString(buf, "(null)", 6); }
+inline void encode(std::streambuf &buf, std::string const& s)	{ putString(buf, s.data(), s.size()); }
+inline void encode(std::streambuf &buf, const void* p)			{ buf.sputc(Pointer); putRaw(buf, p); }
+
+template<class T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+encode(std::streambuf &buf, T i) { buf.sputc(Int); putRaw(buf, (int64_t)i); }
+
+template<class T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+encode(std::streambuf &buf, T u) { buf.sputc(UInt); putRaw(buf, (uint64_t)u); }
+
+template<class T>
+inline typename std::enable_if<std::is_enum<T>::value>::type
+encode(std::streambuf &buf, T e) { encode(buf, (typename std::underlying_type<T>::type)e); }
+
+// anything else is formatted right away
+template<class T>
+inline typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_enum<T>::value
+	&& !std::is_pointer<T>::value && !std::is_array<T>::value>::type
+encode(std::streambuf &buf, T const& x) {
+	std::stringstream s;
+	s << x;
+	encode(buf, s.str());
+}
+
+template<class T>
+inline void encode(std::streambuf &buf, T* p) { encode(buf, (const void*)p); }
+inline void encode(std::streambuf &buf, char* s) { encode(buf, (const char*)s); }
+
+// writes the record header and the arguments
+template<class... Args>
+inline void encodeAll(std::streambuf &buf, logFormat const& fmt, Args const&... args) {
+	static_assert(sizeof...(Args) <= maxArgs, "too many LOGF arguments");
+	putRaw(buf, &fmt);
+	buf.sputc((char)sizeof...(Args));
+	int expand[] = { 0, (encode(buf, args), 0)... };
+	(void)expand;
+}
+
+} // namespace logArgs
+
+// decodes a record produced by logArgs::encodeAll() and writes its text (logger names first) to the stream
+void formatDeferred(std::ostream &out, const char* data, size_t length);
+
+#endif /* UTILS_LOGFORMAT_H_ */
@@ -0,0 +1,49 @@
+/*
+ * mappedFile.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifndef UTILS_MAPPEDFILE_H_
+#define UTILS_MAPPEDFILE_H_
+
+#include <string>
+#include <cstddef>
+
+/*
+ * A read-only memory mapping of a whole file.
+ * The pages are read from disk when they're first touched; prefetch() asks the OS to start reading a range ahead of use.
+ * The mapped memory must not be written to, and the file must not be modified or truncated while it is mapped.
+ */
+class MappedFile {
+public:
+	MappedFile() = default;
+	~MappedFile() { close(); }
+
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator = (MappedFile const&) = delete;
+
+	// returns false (and logs the error) if the file can't be opened or mapped
+	bool open(std::string const& path);
+	void close();
+
+	bool isOpen() const { return data_ != nullptr; }
+	const char* data() const { return data_; }
+	size_t size() const { return size_; }
+
+	// hints that the range will be needed soon (madvise(MADV_WILLNEED)); the range is clamped to the file
+	void prefetch(size_t offset, size_t length) const;
+	// hints that the mapping will be read from start to end, so the OS can read ahead more aggressively
+	void adviseSequential() const;
+
+private:
+	const char* data_ = nullptr;
+	size_t size_ = 0;
+#ifdef __WIN32__
+	void* fileHandle_ = nullptr;
+	void* mappingHandle_ = nullptr;
+#endif
+};
+
+#endif /* UTILS_MAPPEDFILE_H_ */
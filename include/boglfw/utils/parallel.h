@@ -16,19 +16,19 @@
 
 static constexpr size_t maxItemsPerJob = 8;
 
+// queues the jobs for the range [itB, itB+rangeSize) onto the given NUMA node of the pool (or any node)
 template<class ITER, class F>
-void parallel_for(ITER itB, ITER itE, ThreadPool &pool, F predicate)
+void parallel_for_queue(ITER itB, size_t rangeSize, unsigned jobsHint, ThreadPool &pool, unsigned node,
+		F const& predicate, std::vector<PoolTaskHandle> &tasks)
 {
-	size_t rangeSize = std::distance(itB, itE);
 	if (rangeSize == 0)
 		return;
-	unsigned minJobs = std::min((size_t)pool.getThreadCount(), rangeSize);
+	unsigned minJobs = std::max(1u, (unsigned)std::min((size_t)jobsHint, rangeSize));
 	unsigned itemsPerJob = std::min(maxItemsPerJob, rangeSize / minJobs);
 	unsigned jobs = rangeSize / itemsPerJob;
 	if (jobs * itemsPerJob < rangeSize)
 		++jobs;
 
-	std::vector<PoolTaskHandle> tasks;
 	decltype(itB) start = itB;
 
 	for (unsigned i=0; i<jobs; ++i) {
@@ -36,16 +36,49 @@ void parallel_for(ITER itB, ITER itE, ThreadPool &pool, F predicate)
 			// last job - make sure we don't lose any remaining elements:
 			itemsPerJob = rangeSize - (jobs-1)*itemsPerJob;
 		}
-		tasks.push_back(pool.queueTask([start, itemsPerJob, predicate] () mutable {
+		tasks.push_back(pool.queueTaskOnNode(node, [start, itemsPerJob, predicate] () mutable {
 			for (unsigned k=0; k<itemsPerJob; k++, ++start)
 				predicate(*start);
 		}));
 		start += itemsPerJob;
 	}
+}
+
+// queues the work for the range on the pool and returns immediately; the iterators and predicate must stay valid
+// until all returned tasks are finished.
+template<class ITER, class F>
+std::vector<PoolTaskHandle> parallel_for_async(ITER itB, ITER itE, ThreadPool &pool, F predicate)
+{
+	std::vector<PoolTaskHandle> tasks;
+	size_t rangeSize = std::distance(itB, itE);
+	if (rangeSize == 0)
+		return tasks;
+
+	unsigned nodes = pool.getNumaNodeCount();
+	if (nodes == 1)
+		parallel_for_queue(itB, rangeSize, pool.getThreadCount(), pool, ThreadPool::anyNode, predicate, tasks);
+	else {
+		// give each NUMA node one contiguous part of the range, proportional to the number of workers on that node,
+		// so neighbouring elements are processed by workers sharing the same caches and memory controller
+		size_t offset = 0;
+		for (unsigned n=0; n<nodes; n++) {
+			size_t partSize = n == nodes-1
+				? rangeSize - offset
+				: rangeSize * pool.getThreadCountOnNode(n) / pool.getThreadCount();
+			parallel_for_queue(itB + offset, partSize, pool.getThreadCountOnNode(n), pool, n, predicate, tasks);
+			offset += partSize;
+		}
+	}
+	return tasks;
+}
+
+template<class ITER, class F>
+void parallel_for(ITER itB, ITER itE, ThreadPool &pool, F predicate)
+{
+	auto tasks = parallel_for_async(itB, itE, pool, predicate);
 	// wait for pool tasks to finish:
 	for (auto &t : tasks)
 		t->wait();
 }
 
-
 #endif /* UTILS_PARALLEL_H_ */
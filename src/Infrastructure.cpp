@@ -6,14 +6,44 @@
  */
 
 #include <boglfw/Infrastructure.h>
+#include <boglfw/utils/cpuTopology.h>
+#include <boglfw/utils/asyncLogger.h>
 
 #include <thread>
 #include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+static std::atomic_bool initialized { false };
+static InfrastructureConfig config;
+
+void Infrastructure::setConfig(InfrastructureConfig cfg) {
+	if (initialized.load())
+		throw std::runtime_error("Called Infrastructure::setConfig after Infrastructure has been instantiated!!");
+	config = cfg;
+}
 
 Infrastructure::Infrastructure()
-	: threadPool_(std::max(1u, std::thread::hardware_concurrency())) {
+	: threadPool_(std::max(1u, std::thread::hardware_concurrency()), config.threadPoolAffinity) {
+	initialized.store(true, std::memory_order_release);
+	if (config.poolPerPackage) {
+		for (unsigned package : CpuTopology::get().getPackageIds()) {
+			ThreadPoolAffinity affinity;
+			affinity.mode = ThreadPoolAffinity::RestrictToCpus;
+			affinity.cpus = CpuTopology::get().getCpusOnPackage(package);
+			packagePools_.emplace_back(new ThreadPool(affinity.cpus.size(), affinity));
+		}
+	}
 }
 
 void Infrastructure::shutDown_() {
 	threadPool_.stop();
+	for (auto &p : packagePools_)
+		p->stop();
+}
+
+void Infrastructure::shutDown() {
+	getInst(true);
+	// after the thread pools, so that the last lines of the workers are written out too
+	AsyncLogger::stop();
 }
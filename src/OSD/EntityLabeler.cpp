@@ -90,10 +90,10 @@ void EntityLabeler::setEntityLabel(const Entity* ent, std::string const& name, s
 	el.value_ = value;
 	if (!el.label_) {
 		auto xc = [ent] (Viewport const& vp) -> float {
-			return vp.project(ent->getTransform().position()).x;
+			return vp.project(ent->getDrawTransform().position()).x;
 		};
 		auto yc = [ent] (Viewport const& vp) -> float {
-			return vp.project(ent->getTransform().position()).y;
+			return vp.project(ent->getDrawTransform().position()).y;
 		};
 		//el.label_ = std::unique_ptr<Label>(new Label(el.value_, FlexCoordPair(xc, yc), LABEL_TEXT_SIZE, el.rgb_));
 		NOT_IMPLEMENTED;
@@ -13,6 +13,7 @@
 #include <boglfw/math/math3D.h>
 #include <boglfw/utils/log.h>
 #include <boglfw/perf/marker.h>
+#include <boglfw/perf/counters.h>
 
 #include <sstream>
 #include <iomanip>
@@ -57,6 +58,12 @@ void SignalViewer::addSignal(std::string const& name, std::function<float()> get
 	sourceInfo_.push_back(DataInfo(std::unique_ptr<SignalDataSource>(new SignalDataSource(getValue, maxSamples, sampleInterval)), name, rgb, minUpperY, maxLowerY, displayPrecision));
 }
 
+void SignalViewer::addPerfCounter(std::string const& counterName, glm::vec3 const& rgb, float sampleInterval, int maxSamples, float minUpperY, float maxLowerY, int displayPrecision) {
+	// looked up by name because the counter may not be registered yet
+	addSignal(counterName, [counterName] { return (float)perf::Counters::getLastFrameValue(counterName); },
+		rgb, sampleInterval, maxSamples, minUpperY, maxLowerY, displayPrecision);
+}
+
 void SignalViewer::update(float dt) {
 	for (auto &s : sourceInfo_)
 		s.source_->update(dt);
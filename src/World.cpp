@@ -18,6 +18,7 @@
 #include <boglfw/utils/log.h>
 
 #include <boglfw/perf/marker.h>
+#include <boglfw/perf/counters.h>
 
 #include <glm/glm.hpp>
 
@@ -106,6 +107,7 @@ void World::reset() {
 #ifdef DEBUG
 	assertOnMainThread();
 #endif
+	waitPendingUpdate();
 	deferredActions_.clear();
 	pendingActions_.clear();
 	for (auto &e : entities_) {
@@ -252,6 +254,12 @@ void World::takeOverPending() {
 
 void World::update(float dt) {
 	PERF_MARKER_FUNC;
+	if (config.pipelinedUpdate) {
+		// finish the previous update and run the actions it deferred:
+		waitPendingUpdate();
+		executeDeferredActions();
+	}
+
 	++frameNumber_;
 
 	// delete pending entities:
@@ -260,13 +268,38 @@ void World::update(float dt) {
 	// take over pending entities:
 	takeOverPending();
 
+	auto pred = [dt] (Entity* e) {
+		e->update(dt);
+	};
+	PERF_COUNTER("entities-updated", entsToUpdate_.size());
+	PERF_GAUGE("entities", entities_.size());
+
+	if (config.pipelinedUpdate) {
+		// snapshot the state for drawing the current frame while the next update runs:
+		do {
+			PERF_MARKER("capture-draw-state");
+			for (auto e : entsToDraw_)
+				e->captureDrawState();
+		} while (0);
+		if (config.disableParallelProcessing) {
+			auto &ents = entsToUpdate_;
+			pendingUpdateTasks_.push_back(Infrastructure::getThreadPool().queueTask([&ents, pred] {
+				for (auto e : ents)
+					pred(e);
+			}));
+		} else
+			pendingUpdateTasks_ = parallel_for_async(
+				entsToUpdate_.begin(), entsToUpdate_.end(),
+				Infrastructure::getThreadPool(),
+				pred
+			);
+		return;
+	}
+
 	// do the actual update on entities:
 	do {
 	PERF_MARKER("entities-update");
 
-	auto pred = [dt] (Entity* e) {
-		e->update(dt);
-	};
 	if (config.disableParallelProcessing) {
 		for (auto e : entsToUpdate_)
 			pred(e);
@@ -278,20 +311,32 @@ void World::update(float dt) {
 		);
 	} while (0);
 
+	executeDeferredActions();
+}
+
+void World::waitPendingUpdate() {
+	if (pendingUpdateTasks_.empty())
+		return;
+	PERF_MARKER_FUNC_BLOCKED;
+	for (auto &t : pendingUpdateTasks_)
+		t->wait();
+	pendingUpdateTasks_.clear();
+}
+
+void World::executeDeferredActions() {
 	// execute deferred actions synchronously:
-	{
-		PERF_MARKER("deferred-actions");
-		executingDeferredActions_.store(true, std::memory_order_release);
-		pendingActions_.clear();
-		for (auto &a : deferredActions_) {
-			if (a.second-- == 0)
-				a.first();
-			else
-				pendingActions_.push_back(std::move(a));
-		}
-		deferredActions_.swap(pendingActions_);
-		executingDeferredActions_.store(false, std::memory_order_release);
+	PERF_MARKER("deferred-actions");
+	executingDeferredActions_.store(true, std::memory_order_release);
+	pendingActions_.clear();
+	for (auto &a : deferredActions_) {
+		if (a.second-- == 0) {
+			a.first();
+			PERF_COUNTER("deferred-actions-run", 1);
+		} else
+			pendingActions_.push_back(std::move(a));
 	}
+	deferredActions_.swap(pendingActions_);
+	executingDeferredActions_.store(false, std::memory_order_release);
 }
 
 void World::queueDeferredAction(std::function<void()> &&fun, int delayFrames) {
@@ -340,7 +385,7 @@ void World::draw(RenderContext const& ctx) {
 	checkGLError("World::draw() draw boundaries");
 
 	for (auto e : entsToDraw_) {
-		PERF_MARKER((std::string("Entity draw: ") + std::to_string((int)e->getEntityType())).c_str());
+		PERF_MARKER_DYNAMIC((std::string("Entity draw: ") + std::to_string((int)e->getEntityType())).c_str());
 		e->draw(ctx);
 		checkGLError((std::string("after World::draw()::drawEntity ") + std::to_string((int)e->getEntityType())).c_str());
 	}
@@ -21,5 +21,5 @@ void Box::update(float dt) {
 }
 
 void Box::draw(RenderContext const& ctx) {
-	MeshRenderer::get()->renderMesh(mesh_, transform_.glMatrix()/*body_.getTransformation(physics::DynamicBody::TransformSpace::World)*/);
+	MeshRenderer::get()->renderMesh(mesh_, getDrawTransform().glMatrix()/*body_.getTransformation(physics::DynamicBody::TransformSpace::World)*/);
 }
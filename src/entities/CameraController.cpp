@@ -6,6 +6,7 @@
  */
 
 #include <boglfw/entities/CameraController.h>
+#include <boglfw/World.h>
 #include <boglfw/renderOpenGL/Camera.h>
 #include <boglfw/math/math3D.h>
 
@@ -17,6 +18,18 @@ CameraController::~CameraController() {
 }
 
 void CameraController::update(float dt) {
+	if (!camera_)
+		return;
+	if (attachedEntity_.expired())
+		pathLerper_.update(dt);
+	// update() may run on a worker thread while the previous frame is being drawn with the same camera
+	// (see WorldConfig::pipelinedUpdate), so the camera is only moved from the synchronous deferred phase:
+	World::getInstance().queueDeferredAction([this] {
+		applyToCamera();
+	});
+}
+
+void CameraController::applyToCamera() {
 	if (!camera_)
 		return;
 	auto attachedSP = attachedEntity_.lock();
@@ -28,8 +41,6 @@ void CameraController::update(float dt) {
 		glm::vec3 up = tr.axisY();
 		camera_->lookAt(pos + dir, up);
 	} else {
-		attachedSP.reset();
-		pathLerper_.update(dt);
 		camera_->moveTo(pathLerper_.value().position);
 		camera_->lookAt(pathLerper_.value().lookAtTarget);
 	}
@@ -14,5 +14,5 @@ Gizmo::~Gizmo()
 }
 
 void Gizmo::draw(RenderContext const& ctx) {
-	MeshRenderer::get()->renderMesh(mesh_, transform_.glMatrix());
+	MeshRenderer::get()->renderMesh(mesh_, getDrawTransform().glMatrix());
 }
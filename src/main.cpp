@@ -27,10 +27,16 @@
 #include <boglfw/utils/DrawList.h>
 #include <boglfw/utils/UpdateList.h>
 #include <boglfw/utils/rand.h>
+#include <boglfw/utils/filesystem.h>
 
 #include <boglfw/perf/marker.h>
 #include <boglfw/perf/results.h>
 #include <boglfw/perf/frameCapture.h>
+#include <boglfw/perf/traceExport.h>
+#include <boglfw/perf/flightRecorder.h>
+#include <boglfw/perf/counters.h>
+#include <boglfw/perf/allocTracker.h>
+#include <boglfw/perf/baseline.h>
 #include <boglfw/perf/perfPrint.h>
 
 #include <GLFW/glfw3.h>
@@ -53,6 +59,7 @@ bool skipRendering = true;
 bool updatePaused = false;
 bool slowMo = false;
 bool captureFrame = false;
+bool toggleFlightRecorder = false;
 b2World *pPhysWld = nullptr;
 PhysicsDebugDraw *pPhysicsDraw = nullptr;
 
@@ -86,6 +93,9 @@ void onInputEventHandler(InputEvent& ev) {
 	} else if (ev.key == GLFW_KEY_F1) {
 		if (ev.type == InputEvent::EV_KEY_DOWN)
 			captureFrame = true;
+	} else if (ev.key == GLFW_KEY_F2) {
+		if (ev.type == InputEvent::EV_KEY_DOWN)
+			toggleFlightRecorder = true;
 	}
 }
 
@@ -186,6 +196,8 @@ int main(int argc, char* argv[]) {
 
 		sigViewer.addSignal("frameTime", &frameTime,
 				glm::vec3(1.f, 0.2f, 0.2f), 0.1f, 50, 0.1, 0, 3);
+		sigViewer.addPerfCounter("draw-calls",
+				glm::vec3(0.2f, 0.8f, 1.f), 0.1f, 50, 10, 0, 0);
 
 		auto infoTexts = [&](Viewport*) {
 			GLText::get()->print("Salut Lume!\n[Powered by Box2D]",
@@ -210,6 +222,15 @@ int main(int argc, char* argv[]) {
 
 		float t = glfwGetTime();
 		while (GLFWInput::checkInput()) {
+			if (toggleFlightRecorder) {
+				toggleFlightRecorder = false;
+				if (perf::FlightRecorder::isRunning())
+					perf::FlightRecorder::stop();
+				else
+					perf::FlightRecorder::start();
+			}
+			if (perf::FlightRecorder::isRunning())
+				captureFrame = false;	// the flight recorder owns the frame capture
 			if (captureFrame)
 				perf::FrameCapture::start(perf::FrameCapture::AllThreads);
 			/* frame context */
@@ -254,27 +275,57 @@ int main(int argc, char* argv[]) {
 					// now rendering is on-going, move on to the next update:
 				}
 			} /* frame context */
+			perf::Counters::frameBoundary();
+			perf::AllocationTracker::frameBoundary();
 
 			if (captureFrame) {
 				captureFrame = false;
 				perf::FrameCapture::stop();
-				printFrameCaptureData(perf::FrameCapture::getResults());
+				auto frameData = perf::FrameCapture::getResults();
+				printFrameCaptureData(frameData);
+				if (perf::AllocationTracker::isEnabled()) {
+					std::cout << "\n------------ TOP ALLOCATORS THIS FRAME -------------\n";
+					printTopAllocators(perf::AllocationTracker::getTopAllocators(10));
+				}
+				auto captureStart = perf::FrameCapture::getCaptureStartTime();
+				perf::exportChromeTrace(frameData, "frame-capture.json", perf::Counters::getTraceSamples(captureStart, captureStart));
 				perf::FrameCapture::cleanup();
 			}
+			perf::FlightRecorder::frameBoundary();
 		}
+		perf::FlightRecorder::stop();
 
 		renderer.unload();
 		Infrastructure::shutDown();
 	} while (0);
 
-	for (unsigned i=0; i<perf::Results::getNumberOfThreads(); i++) {
-		std::cout << "\n=============Call Tree for thread [" << perf::Results::getThreadName(i) << "]==========================================\n";
-		printCallTree(perf::Results::getCallTrees(i), 0);
+	// threads sharing the same name (such as the thread pool workers) are shown merged together
+	for (auto &threadName : perf::Results::getThreadNames()) {
+		std::cout << "\n=============Call Tree for thread [" << threadName << "]==========================================\n";
+		printCallTree(perf::Results::getMergedCallTrees(threadName), 0);
 		std::cout << "\n------------ TOP HITS -------------\n";
-		printTopHits(perf::Results::getFlatList(i));
+		printTopHits(perf::Results::getMergedFlatList(threadName));
 		std::cout << "\n--------------- END -------------------------------\n";
 	}
 
+	if (perf::AllocationTracker::isEnabled()) {
+		std::cout << "\n------------ TOP ALLOCATORS -------------\n";
+		printTopAllocators(perf::AllocationTracker::getTotalAllocations(10));
+	}
+
+	std::cout << "\n------------ LOCKS -------------\n";
+	printLockStats(perf::ProfiledMutex::getStats());
+
+	// compare against the previous run and save this one for the next
+	const std::string baselinePath = "perf-baseline.dat";
+	auto baseline = perf::Baseline::capture();
+	perf::Baseline previous;
+	if (filesystem::pathExists(baselinePath) && perf::Baseline::load(baselinePath, previous)) {
+		std::cout << "\n------------ CHANGES SINCE LAST RUN -------------\n";
+		printBaselineDiff(perf::diffBaselines(previous, baseline), 15);
+	}
+	baseline.save(baselinePath);
+
 	std::cout << "\n\n";
 
 	return 0;
@@ -3,6 +3,8 @@
 #include <boglfw/net/udp.h>
 
 #include <boglfw/utils/semaphore.h>
+#include <boglfw/perf/counters.h>
+#include <boglfw/perf/profiledMutex.h>
 
 #include <asio.hpp>
 
@@ -47,16 +49,17 @@ static std::vector<tcp::acceptor*> listenersToDelete;
 static std::vector<UDPSocketWrapper*> udpSockets;
 static std::atomic_int asyncOperations {0};
 static semaphore workAvail;
-static std::mutex asyncOpMutex;		// used to synchronize the changes to io_context run thread's state with operations that create or destroy
-												// async objects such as connections and listeners
+// used to synchronize the changes to io_context run thread's state with operations that create or destroy
+// async objects such as connections and listeners
+static perf::ProfiledMutex asyncOpMutex { "net::asyncOpMutex" };
 
 static void checkStart();	// checks if a worker thread is running and if not it starts one for all async operations
-static void checkFinish(std::unique_lock<std::mutex> &lk);	// checks if all connections and listeners are closed and if so, shuts down the worker thread
+static void checkFinish(std::unique_lock<perf::ProfiledMutex> &lk);	// checks if all connections and listeners are closed and if so, shuts down the worker thread
 static result translateError(const asio::error_code &err);
 
 static tcp::socket* getSocket(connection con) {
 	assertDbg(con < connections.size() && connections[con] != nullptr);
-	std::lock_guard<std::mutex> lk(asyncOpMutex);
+	std::lock_guard<perf::ProfiledMutex> lk(asyncOpMutex);
 	return connections[con];
 }
 
@@ -64,7 +67,7 @@ void startListenImpl(tcp::acceptor* acceptor, newConnectionCallback callback) {
 	tcp::socket* clientSocket = new tcp::socket(theIoContext);
 	acceptor->async_accept(*clientSocket, [acceptor, clientSocket, callback](const asio::error_code& error) {
 		if (!error) {
-			std::unique_lock<std::mutex> lk(asyncOpMutex);
+			std::unique_lock<perf::ProfiledMutex> lk(asyncOpMutex);
 			connections.push_back(clientSocket);
 			auto connectionId = connections.size() - 1;
 			lk.unlock();
@@ -82,7 +85,7 @@ void startListenImpl(tcp::acceptor* acceptor, newConnectionCallback callback) {
 
 listener startListen(uint16_t port, newConnectionCallback callback) {
 	tcp::acceptor* acceptor = new tcp::acceptor(theIoContext, tcp::endpoint(tcp::v4(), port));
-	std::lock_guard<std::mutex> lk(asyncOpMutex);
+	std::lock_guard<perf::ProfiledMutex> lk(asyncOpMutex);
 	listeners.push_back(acceptor);
 	listener ret = listeners.size() - 1;
 	startListenImpl(acceptor, callback);
@@ -91,7 +94,7 @@ listener startListen(uint16_t port, newConnectionCallback callback) {
 }
 
 void stopListen(listener lis) {
-	std::unique_lock<std::mutex> lk(asyncOpMutex);
+	std::unique_lock<perf::ProfiledMutex> lk(asyncOpMutex);
 	assertDbg(lis < listeners.size() && listeners[lis] != nullptr);
 	listeners[lis]->cancel();
 	listeners[lis]->close();
@@ -107,7 +110,7 @@ result connect(std::string host, uint16_t port, connection& outCon) {
 	asio::error_code err;
     asio::connect(*newSocket, endpoints, err);
 	if (!err) {
-		std::lock_guard<std::mutex> lk(asyncOpMutex);
+		std::lock_guard<perf::ProfiledMutex> lk(asyncOpMutex);
 		connections.push_back(newSocket);
 		outCon = connections.size() - 1;
 		return result::ok;
@@ -121,13 +124,13 @@ void connect_async(std::string host, uint16_t port, newConnectionCallback callba
 	tcp::resolver resolver(theIoContext);
     tcp::resolver::query query(host, std::to_string(port));
 	tcp::socket* newSocket = new tcp::socket(theIoContext);
-	std::unique_lock<std::mutex> lk(asyncOpMutex);
+	std::unique_lock<perf::ProfiledMutex> lk(asyncOpMutex);
 	connections.push_back(newSocket);
 	auto connectionId = connections.size() - 1;
 	lk.unlock();
 	resolver.async_resolve(query, [callback, newSocket, connectionId] (const asio::error_code &err, tcp::resolver::iterator endpointIter) {
 		if (err) {
-			std::unique_lock<std::mutex> lk(asyncOpMutex);
+			std::unique_lock<perf::ProfiledMutex> lk(asyncOpMutex);
 			delete newSocket;
 			connections[connectionId] = nullptr;
 			checkFinish(lk);
@@ -138,7 +141,7 @@ void connect_async(std::string host, uint16_t port, newConnectionCallback callba
 				if (!err) {
 					callback(result::ok, connectionId);
 				} else {
-					std::unique_lock<std::mutex> lk(asyncOpMutex);
+					std::unique_lock<perf::ProfiledMutex> lk(asyncOpMutex);
 					delete newSocket;
 					connections[connectionId] = nullptr;
 					checkFinish(lk);
@@ -155,7 +158,7 @@ void connect_async(std::string host, uint16_t port, newConnectionCallback callba
 }
 
 void closeConnection(connection con) {
-	std::unique_lock<std::mutex> lk(asyncOpMutex);
+	std::unique_lock<perf::ProfiledMutex> lk(asyncOpMutex);
 	assertDbg(con < connections.size() && connections[con] != nullptr);
 	connections[con]->shutdown(tcp::socket::shutdown_both);
 	connections[con]->close();
@@ -167,7 +170,8 @@ void closeConnection(connection con) {
 result write(connection con, const void* buffer, size_t count) {
 	auto socket = getSocket(con);
 	asio::error_code err;
-	asio::write(*socket, asio::buffer(buffer, count), err);
+	auto nSent = asio::write(*socket, asio::buffer(buffer, count), err);
+	PERF_COUNTER("net-bytes-sent", nSent);
 	return translateError(err);
 }
 
@@ -219,7 +223,7 @@ static void checkStart() {
 	}
 }
 
-static void checkFinish(std::unique_lock<std::mutex> &lk) {
+static void checkFinish(std::unique_lock<perf::ProfiledMutex> &lk) {
 	// we are currently under asyncOpMutex lock by the caller
 	// count how many live connections/listeners we have:
 	unsigned nObjects = asyncOperations.load(std::memory_order::memory_order_acquire);
@@ -298,7 +302,7 @@ udpSocket createMulticastSendSocket(std::string multicastAddress, unsigned short
 	//newSock->socket.set_option(asio::ip::multicast::enable_loopback(true));
 	//newSock->socket.set_option(asio::socket_base::broadcast(true));
 
-	std::lock_guard<std::mutex> lk(asyncOpMutex);
+	std::lock_guard<perf::ProfiledMutex> lk(asyncOpMutex);
 	udpSockets.push_back(newSock);
 	return udpSockets.size() - 1;
 }
@@ -313,7 +317,7 @@ udpSocket createMulticastReceiveSocket(std::string listenAddress, std::string mu
 	newSock->socket.bind(newSock->endpoint);
 	newSock->socket.set_option(asio::ip::multicast::join_group(asio::ip::make_address(multicastGroup)));
 
-	std::lock_guard<std::mutex> lk(asyncOpMutex);
+	std::lock_guard<perf::ProfiledMutex> lk(asyncOpMutex);
 	udpSockets.push_back(newSock);
 	return udpSockets.size() - 1;
 }
@@ -325,7 +329,7 @@ udpSocket createUDPSocket(unsigned short port) {
 
 // closes a UDP socket
 void closeSocket(udpSocket socket) {
-	std::lock_guard<std::mutex> lk(asyncOpMutex);
+	std::lock_guard<perf::ProfiledMutex> lk(asyncOpMutex);
 	assertDbg(socket < udpSockets.size() && udpSockets[socket] != nullptr);
 	udpSockets[socket]->socket.close();
 	delete udpSockets[socket];
@@ -337,10 +341,11 @@ void closeSocket(udpSocket socket) {
 // the call is blocking.
 // if the provided socket is a multicast socket, the write operation will be treated as a multicast, otherwise as unicas
 result writeUDP(udpSocket socket, const void* buffer, size_t count) {
-	std::lock_guard<std::mutex> lk(asyncOpMutex);
+	std::lock_guard<perf::ProfiledMutex> lk(asyncOpMutex);
 	assertDbg(socket < udpSockets.size() && udpSockets[socket] != nullptr);
 	if (udpSockets[socket]->isMulticast) {
 		auto nSent = udpSockets[socket]->socket.send_to(asio::buffer(buffer, count), udpSockets[socket]->endpoint);
+		PERF_COUNTER("net-bytes-sent", nSent);
 		if (nSent == count)
 			return result::ok;
 		else
@@ -358,7 +363,7 @@ result writeUDP(udpSocket socket, const void* buffer, size_t count) {
 result readUDP(udpSocket socket, void* buffer, size_t bufSize,  size_t &out_count, endpointInfo& out_sender) {
 	asio::ip::udp::socket* pSocket = nullptr;
 	{
-		std::lock_guard<std::mutex> lk(asyncOpMutex);
+		std::lock_guard<perf::ProfiledMutex> lk(asyncOpMutex);
 		assertDbg(socket < udpSockets.size() && udpSockets[socket] != nullptr);
 		pSocket = &udpSockets[socket]->socket;
 	}
@@ -371,7 +376,7 @@ result readUDP(udpSocket socket, void* buffer, size_t bufSize,  size_t &out_coun
 void readUDPAsync(udpSocket socket, void* buffer, size_t bufSize, udpReceiveCallback cb) {
 	asio::ip::udp::socket* pSocket = nullptr;
 	{
-		std::lock_guard<std::mutex> lk(asyncOpMutex);
+		std::lock_guard<perf::ProfiledMutex> lk(asyncOpMutex);
 		assertDbg(socket < udpSockets.size() && udpSockets[socket] != nullptr);
 		pSocket = &udpSockets[socket]->socket;
 	}
@@ -380,11 +385,11 @@ void readUDPAsync(udpSocket socket, void* buffer, size_t bufSize, udpReceiveCall
 		[cb, senderEndpoint](const asio::error_code& error, size_t bytes_transferred) {
 			cb(translateError(error), bytes_transferred, endpointInfo{senderEndpoint->address().to_string()});
 			delete senderEndpoint;
-			std::unique_lock<std::mutex> lk(asyncOpMutex);
+			std::unique_lock<perf::ProfiledMutex> lk(asyncOpMutex);
 			asyncOperations--;
 			checkFinish(lk);
 		});
-	std::lock_guard<std::mutex> lk(asyncOpMutex);
+	std::lock_guard<perf::ProfiledMutex> lk(asyncOpMutex);
 	asyncOperations++;
 	checkStart();
 	workAvail.notify();
@@ -0,0 +1,160 @@
+/*
+ * allocTracker.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/perf/allocTracker.h>
+#include <boglfw/perf/callGraph.h>
+#include <boglfw/perf/results.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace perf {
+
+thread_local allocStats* AllocationTracker::crtTarget_ = nullptr;
+std::vector<AllocationTracker::SectionAllocations> AllocationTracker::lastFrame_;
+std::vector<AllocationTracker::SectionAllocations> AllocationTracker::totals_;
+
+bool AllocationTracker::isEnabled() {
+#ifdef PERF_TRACK_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+void AllocationTracker::frameBoundary() {
+	if (!isEnabled())
+		return;
+	std::vector<uint64_t> counts, bytes;
+	for (unsigned i=0; i<Results::threadGraphs_.size(); i++) {
+		auto &graph = *Results::threadGraphs_[i];
+		std::lock_guard<std::mutex> lk(graph.allocStatsMutex_);
+		if (counts.size() < graph.allocStatsById_.size()) {
+			counts.resize(graph.allocStatsById_.size(), 0);
+			bytes.resize(graph.allocStatsById_.size(), 0);
+		}
+		for (unsigned id=0; id<graph.allocStatsById_.size(); id++) {
+			counts[id] += graph.allocStatsById_[id].count.load(std::memory_order_relaxed);
+			bytes[id] += graph.allocStatsById_[id].bytes.load(std::memory_order_relaxed);
+		}
+	}
+
+	// the previous totals are indexed by section id as well
+	std::vector<SectionAllocations> prevTotals(counts.size(), SectionAllocations{0, "", 0, 0});
+	for (auto &t : totals_)
+		if (t.sectionId < prevTotals.size())
+			prevTotals[t.sectionId] = t;
+
+	lastFrame_.clear();
+	totals_.clear();
+	for (unsigned id=0; id<counts.size(); id++) {
+		if (counts[id] == 0)
+			continue;
+		std::string name = getSectionName(id);
+		totals_.push_back({id, name, counts[id], bytes[id]});
+		if (counts[id] > prevTotals[id].count)
+			lastFrame_.push_back({id, name, counts[id] - prevTotals[id].count, bytes[id] - prevTotals[id].bytes});
+	}
+	auto byCount = [] (SectionAllocations const& x, SectionAllocations const& y) {
+		return x.count > y.count;
+	};
+	std::sort(lastFrame_.begin(), lastFrame_.end(), byCount);
+	std::sort(totals_.begin(), totals_.end(), byCount);
+}
+
+std::vector<AllocationTracker::SectionAllocations> AllocationTracker::getTopAllocators(unsigned maxCount) {
+	return std::vector<SectionAllocations>(lastFrame_.begin(), lastFrame_.begin() + std::min<size_t>(maxCount, lastFrame_.size()));
+}
+
+std::vector<AllocationTracker::SectionAllocations> AllocationTracker::getTotalAllocations(unsigned maxCount) {
+	return std::vector<SectionAllocations>(totals_.begin(), totals_.begin() + std::min<size_t>(maxCount, totals_.size()));
+}
+
+} /* namespace perf */
+
+#ifdef PERF_TRACK_ALLOCATIONS
+
+// The hooks must not allocate and must not call into anything that might (AllocationTracker::record() only touches
+// a thread_local pointer and the counters it points to).
+#ifdef __GLIBC__
+
+// on glibc operator new goes through malloc, so hooking the C allocator catches everything
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size) {
+	perf::AllocationTracker::record(size);
+	return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) {
+	perf::AllocationTracker::record(n * size);
+	return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+	perf::AllocationTracker::record(size);
+	return __libc_realloc(ptr, size);
+}
+
+} // extern "C"
+
+#else // __GLIBC__
+
+// elsewhere only the C++ allocations can be hooked portably
+void* operator new(size_t size) {
+	perf::AllocationTracker::record(size);
+	void* p = std::malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void* operator new(size_t size, std::nothrow_t const&) noexcept {
+	perf::AllocationTracker::record(size);
+	return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, std::nothrow_t const& nt) noexcept {
+	return operator new(size, nt);
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::nothrow_t const&) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, std::nothrow_t const&) noexcept {
+	std::free(p);
+}
+
+#endif // __GLIBC__
+
+#endif // PERF_TRACK_ALLOCATIONS
@@ -0,0 +1,246 @@
+/*
+ * baseline.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/perf/baseline.h>
+#include <boglfw/perf/results.h>
+#include <boglfw/perf/section.h>
+#include <boglfw/serialization/BinaryStream.h>
+#include <boglfw/utils/log.h>
+
+#include <fstream>
+#include <map>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace perf {
+
+static constexpr uint32_t BASELINE_MAGIC = 0x42465250; // "PRFB"
+static constexpr uint32_t BASELINE_VERSION = 1;
+
+static BaselineSection makeBaselineSection(sectionData const& s, std::string const& path) {
+	BaselineSection ret;
+	ret.path = path;
+	ret.executionCount = s.getExecutionCount();
+	ret.inclusiveNanosec = s.getInclusiveNanosec();
+	ret.exclusiveNanosec = s.getExclusiveNanosec();
+	ret.p50 = s.getPercentileNanosec(50);
+	ret.p90 = s.getPercentileNanosec(90);
+	ret.p99 = s.getPercentileNanosec(99);
+	ret.max = s.getMaxNanosec();
+	ret.stdDevNanosec = (uint64_t)s.getHistogram().getStdDev(ret.getMeanNanosec());
+	return ret;
+}
+
+static void addTree(std::vector<BaselineSection> &out, std::shared_ptr<sectionData> const& s, std::string const& parentPath) {
+	std::string path = parentPath.empty() ? s->getName() : parentPath + " > " + s->getName();
+	out.push_back(makeBaselineSection(*s, path));
+	for (auto &c : s->getCallees())
+		addTree(out, c, path);
+}
+
+Baseline Baseline::capture() {
+	Baseline ret;
+	for (auto &name : Results::getThreadNames()) {
+		BaselineThread t;
+		t.name = name;
+		for (auto &s : Results::getMergedFlatList(name))
+			t.flat.push_back(makeBaselineSection(s, s.getName()));
+		for (auto &root : Results::getMergedCallTrees(name))
+			addTree(t.tree, root, "");
+		ret.threads.push_back(std::move(t));
+	}
+	return ret;
+}
+
+static BinaryStream& operator << (BinaryStream &stream, BaselineSection const& s) {
+	stream << s.path << s.executionCount << s.inclusiveNanosec << s.exclusiveNanosec
+		<< s.p50 << s.p90 << s.p99 << s.max << s.stdDevNanosec;
+	return stream;
+}
+
+static BinaryStream& operator >> (BinaryStream &stream, BaselineSection &s) {
+	stream >> s.path >> s.executionCount >> s.inclusiveNanosec >> s.exclusiveNanosec
+		>> s.p50 >> s.p90 >> s.p99 >> s.max >> s.stdDevNanosec;
+	return stream;
+}
+
+static void writeSections(BinaryStream &stream, std::vector<BaselineSection> const& sections) {
+	stream << (uint32_t)sections.size();
+	for (auto &s : sections)
+		stream << s;
+}
+
+// throws if the remaining data can't possibly hold <count> elements of at least <minElementSize> bytes each,
+// so a corrupted count fails the load instead of attempting a huge allocation
+static void checkCount(BinaryStream &stream, uint32_t count, size_t minElementSize) {
+	if (count > (stream.size() - stream.getPos()) / minElementSize)
+		throw std::runtime_error("element count " + std::to_string(count) + " exceeds the remaining data");
+}
+
+static void readSections(BinaryStream &stream, std::vector<BaselineSection> &sections) {
+	uint32_t count = 0;
+	stream >> count;
+	// path length + 8 uint64 fields
+	checkCount(stream, count, sizeof(uint16_t) + 8 * sizeof(uint64_t));
+	sections.resize(count);
+	for (auto &s : sections)
+		stream >> s;
+}
+
+bool Baseline::save(std::string const& path) const {
+	LOGPREFIX("perf::Baseline");
+	BinaryStream stream(4096);
+	stream << BASELINE_MAGIC << BASELINE_VERSION << (uint32_t)threads.size();
+	for (auto &t : threads) {
+		stream << t.name;
+		writeSections(stream, t.flat);
+		writeSections(stream, t.tree);
+	}
+	std::ofstream file(path, std::ios::out | std::ios::binary);
+	if (!file.is_open()) {
+		ERROR("Could not open \"" << path << "\" for writing!");
+		return false;
+	}
+	file.write((const char*)stream.getBuffer(), stream.size());
+	if (!file.good()) {
+		ERROR("Failed writing \"" << path << "\"");
+		return false;
+	}
+	return true;
+}
+
+bool Baseline::load(std::string const& path, Baseline &out) {
+	LOGPREFIX("perf::Baseline");
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if (!file.is_open()) {
+		ERROR("Could not open \"" << path << "\"");
+		return false;
+	}
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	try {
+		BinaryStream stream(data.data(), data.size());
+		uint32_t magic = 0, version = 0, threadCount = 0;
+		stream >> magic;
+		if (magic != BASELINE_MAGIC) {
+			LOGLN("WARNING: Invalid or corrupted perf baseline (wrong magic!) at: " << path);
+			return false;
+		}
+		stream >> version;
+		if (version != BASELINE_VERSION) {
+			LOGLN("WARNING: No known method to handle version " << version << " of perf baseline! canceling...");
+			return false;
+		}
+		stream >> threadCount;
+		// name length + the two section counts
+		checkCount(stream, threadCount, sizeof(uint16_t) + 2 * sizeof(uint32_t));
+		Baseline ret;
+		ret.threads.resize(threadCount);
+		for (auto &t : ret.threads) {
+			stream >> t.name;
+			readSections(stream, t.flat);
+			readSections(stream, t.tree);
+		}
+		out = std::move(ret);
+		return true;
+	} catch (std::runtime_error &e) {
+		ERROR("EXCEPTION during deserialization from file " << path << ":\n" << e.what());
+		return false;
+	}
+}
+
+static void compareSections(std::vector<BaselineSectionDiff> &out, std::string const& thread, bool fromTree,
+		std::vector<BaselineSection> const& base, std::vector<BaselineSection> const& current, BaselineDiffOptions const& opt) {
+	std::map<std::string, BaselineSection const*> baseByPath;
+	for (auto &s : base)
+		baseByPath[s.path] = &s;
+	for (auto &c : current) {
+		BaselineSectionDiff d;
+		d.thread = thread;
+		d.path = c.path;
+		d.fromTree = fromTree;
+		d.current = c;
+		auto it = baseByPath.find(c.path);
+		if (it == baseByPath.end()) {
+			d.onlyInCurrent = true;
+			d.absoluteChangeNanosec = c.getMeanNanosec();
+			d.relativeChange = INFINITY;
+			out.push_back(d);
+			continue;
+		}
+		d.base = *it->second;
+		baseByPath.erase(it);
+
+		double meanBase = d.base.getMeanNanosec(), meanCrt = c.getMeanNanosec();
+		d.absoluteChangeNanosec = meanCrt - meanBase;
+		d.relativeChange = meanBase > 0 ? d.absoluteChangeNanosec / meanBase : 0;
+		// Welch's t-test on the mean execution time
+		double varBase = (double)d.base.stdDevNanosec * d.base.stdDevNanosec;
+		double varCrt = (double)c.stdDevNanosec * c.stdDevNanosec;
+		double stdErr = std::sqrt(varBase / std::max<uint64_t>(1, d.base.executionCount) + varCrt / std::max<uint64_t>(1, c.executionCount));
+		if (stdErr > 0)
+			d.tScore = d.absoluteChangeNanosec / stdErr;
+		else if (d.absoluteChangeNanosec != 0)
+			d.tScore = d.absoluteChangeNanosec > 0 ? INFINITY : -INFINITY;
+		bool significant = d.base.executionCount > 1 && c.executionCount > 1
+				&& std::abs(d.tScore) >= opt.minTScore
+				&& std::abs(d.relativeChange) >= opt.minRelativeChange
+				&& std::abs(d.absoluteChangeNanosec) >= opt.minAbsoluteNanosec;
+		d.regression = significant && d.absoluteChangeNanosec > 0;
+		d.improvement = significant && d.absoluteChangeNanosec < 0;
+		out.push_back(d);
+	}
+	for (auto &p : baseByPath) {
+		BaselineSectionDiff d;
+		d.thread = thread;
+		d.path = p.first;
+		d.fromTree = fromTree;
+		d.onlyInBase = true;
+		d.base = *p.second;
+		d.absoluteChangeNanosec = -d.base.getMeanNanosec();
+		d.relativeChange = -1;
+		out.push_back(d);
+	}
+}
+
+std::vector<BaselineSectionDiff> diffBaselines(Baseline const& base, Baseline const& current, BaselineDiffOptions const& options) {
+	std::vector<BaselineSectionDiff> ret;
+	static const BaselineThread emptyThread;
+	for (auto &ct : current.threads) {
+		auto bt = std::find_if(base.threads.begin(), base.threads.end(), [&ct] (auto &t) { return t.name == ct.name; });
+		auto &baseThread = bt != base.threads.end() ? *bt : emptyThread;
+		compareSections(ret, ct.name, false, baseThread.flat, ct.flat, options);
+		if (options.includeTree)
+			compareSections(ret, ct.name, true, baseThread.tree, ct.tree, options);
+	}
+	for (auto &bt : base.threads) {
+		if (std::find_if(current.threads.begin(), current.threads.end(), [&bt] (auto &t) { return t.name == bt.name; }) != current.threads.end())
+			continue;
+		compareSections(ret, bt.name, false, bt.flat, {}, options);
+		if (options.includeTree)
+			compareSections(ret, bt.name, true, bt.tree, {}, options);
+	}
+	sortBaselineDiff(ret, options.ranking);
+	return ret;
+}
+
+void sortBaselineDiff(std::vector<BaselineSectionDiff> &diff, BaselineDiffRanking ranking) {
+	switch (ranking) {
+	case BaselineDiffRanking::AbsoluteChange:
+		std::stable_sort(diff.begin(), diff.end(), [] (auto &x, auto &y) {
+			return x.absoluteChangeNanosec > y.absoluteChangeNanosec;
+		});
+		break;
+	case BaselineDiffRanking::RelativeChange:
+		std::stable_sort(diff.begin(), diff.end(), [] (auto &x, auto &y) {
+			return x.relativeChange > y.relativeChange;
+		});
+		break;
+	}
+}
+
+} /* namespace perf */
@@ -8,7 +8,6 @@
 #include <boglfw/perf/callGraph.h>
 #include <boglfw/perf/results.h>
 
-#include <cstring>
 #include <algorithm>
 
 namespace perf {
@@ -23,40 +22,63 @@ CallGraph& CallGraph::getCrtThreadInstance() {
 	return *crtThreadInstance_;
 }
 
-void CallGraph::pushSection(const char name[], bool deadTime) {
+void CallGraph::pushSection(unsigned id, bool deadTime) {
+	auto &graph = getCrtThreadInstance();
 	// add to call-trees:
-	std::vector<std::shared_ptr<sectionData>> &treeContainer =
-		getCrtThreadInstance().crtStack_.empty()
-			? getCrtThreadInstance().rootTrees_
-			: getCrtThreadInstance().crtStack_.top()->callees_;
-	auto treeIt = std::find_if(treeContainer.begin(), treeContainer.end(), [&name] (auto &sec) {
-		return !std::strcmp(sec->name_, name);
-	});
-	if (treeIt == treeContainer.end()) {
-		treeContainer.emplace_back(sectionData::make_shared(name));
-		treeIt = treeContainer.end()-1;
+	sectionData* parent = graph.crtStack_.empty() ? nullptr : graph.crtStack_.top();
+	std::vector<std::shared_ptr<sectionData>> &treeContainer = parent ? parent->callees_ : graph.rootTrees_;
+	std::vector<unsigned> &ids = parent ? parent->calleeIds_ : graph.rootTreeIds_;
+	sectionData* node = nullptr;
+	auto idIt = std::find(ids.begin(), ids.end(), id);
+	if (idIt != ids.end())
+		node = treeContainer[idIt - ids.begin()].get();
+	else {
+		treeContainer.emplace_back(sectionData::make_shared(id));
+		ids.push_back(id);
+		node = treeContainer.back().get();
 	}
-	(*treeIt)->deadTime_ = deadTime;
-	getCrtThreadInstance().crtStack_.push(treeIt->get());
+	node->deadTime_ = deadTime;
+	graph.crtStack_.push(node);
+#ifdef PERF_TRACK_ALLOCATIONS
+	AllocationTracker::crtTarget_ = &graph.getAllocStats(id);
+#endif
 }
 
 void CallGraph::popSection(uint64_t nanoseconds) {
-	auto &stack = getCrtThreadInstance().crtStack_;
+	auto &graph = getCrtThreadInstance();
+	auto &stack = graph.crtStack_;
 	// add time to secion, ++callCount
 	sectionData *pCrt = stack.top();
 	pCrt->executionCount_++;
 	pCrt->nanoseconds_ += nanoseconds;
+	pCrt->histogram_.record(nanoseconds);
 	stack.pop();
+#ifdef PERF_TRACK_ALLOCATIONS
+	static const unsigned noSectionId = internSectionName("{no section}");
+	AllocationTracker::crtTarget_ = &graph.getAllocStats(stack.empty() ? noSectionId : stack.top()->id_);
+#endif
 
 	// add time to flat list:
-	auto &flatList = getCrtThreadInstance().flatSectionData_;
+	auto &flatList = graph.flatSectionData_;
+	if (pCrt->id_ >= flatList.size())
+		flatList.resize(pCrt->id_ + 1);
+	auto &flat = flatList[pCrt->id_];
+	if (!flat) {
+		flat = sectionData::make_unique(pCrt->id_);
+		flat->deadTime_ = pCrt->deadTime_;
+	}
+	flat->executionCount_++;
+	flat->nanoseconds_ += nanoseconds;
+	flat->histogram_.record(nanoseconds);
+}
 
-	auto it = flatList.find(pCrt->name_);
-	if (it == flatList.end()) {
-		it = flatList.emplace(pCrt->name_, sectionData::make_unique(pCrt->name_)).first;
+allocStats& CallGraph::getAllocStats(unsigned id) {
+	if (id >= allocStatsById_.size()) {
+		std::lock_guard<std::mutex> lk(allocStatsMutex_);
+		while (allocStatsById_.size() <= id)
+			allocStatsById_.emplace_back();
 	}
-	it->second->executionCount_++;
-	it->second->nanoseconds_ += nanoseconds;
+	return allocStatsById_[id];
 }
 
 } // namespace
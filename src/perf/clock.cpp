@@ -0,0 +1,62 @@
+/*
+ * clock.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/perf/clock.h>
+
+#ifdef PERF_TSC_CLOCK_ENABLED
+#include <cpuid.h>
+#endif
+
+namespace perf {
+
+// until this is initialized (during static initialization) now() falls back to steady_clock;
+// this runs before main(), so it must not log - use Clock::isUsingTsc() to find out the outcome
+Clock::tscCalibration Clock::tsc_ = Clock::calibrate();
+
+Clock::tscCalibration Clock::calibrate() {
+	tscCalibration ret;
+#ifdef PERF_TSC_CLOCK_ENABLED
+	// invariant TSC (constant rate across P-/C-states and synchronized between cores): CPUID 0x80000007, EDX bit 8
+	unsigned eax, ebx, ecx, edx;
+	if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8)))
+		return ret;
+	using namespace std::chrono;
+	// measure the TSC against steady_clock over a short interval;
+	// each end point is taken as the tightest of a few (steady, tsc, steady) samples to reduce noise
+	auto sample = [] (int64_t &nanosec, uint64_t &tsc) {
+		int64_t bestSpan = INT64_MAX;
+		for (int i=0; i<5; i++) {
+			auto t0 = steady_clock::now();
+			uint64_t c = __rdtsc();
+			auto t1 = steady_clock::now();
+			int64_t span = duration_cast<nanoseconds>(t1 - t0).count();
+			if (span < bestSpan) {
+				bestSpan = span;
+				nanosec = duration_cast<nanoseconds>(t0.time_since_epoch()).count() + span / 2;
+				tsc = c;
+			}
+		}
+	};
+	int64_t ns0, ns1;
+	uint64_t tsc0, tsc1;
+	sample(ns0, tsc0);
+	auto spinUntil = steady_clock::now() + milliseconds(10);
+	while (steady_clock::now() < spinUntil);
+	sample(ns1, tsc1);
+	if (tsc1 <= tsc0 || ns1 <= ns0)
+		return ret;
+	double nsPerTick = double(ns1 - ns0) / (tsc1 - tsc0);
+	ret.tscBase = tsc1;
+	ret.nanosecBase = ns1;
+	ret.nanosecPerTickFx32 = (uint64_t)(nsPerTick * 4294967296.0);
+	ret.frequency = 1.e9 / nsPerTick;
+	ret.available = true;
+#endif
+	return ret;
+}
+
+} /* namespace perf */
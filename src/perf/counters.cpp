@@ -0,0 +1,122 @@
+/*
+ * counters.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/perf/counters.h>
+#include <boglfw/perf/traceExport.h>
+#include <boglfw/utils/assert.h>
+#include <boglfw/utils/log.h>
+
+#include <unordered_map>
+
+namespace perf {
+
+struct counterInfo {
+	std::string name;
+	CounterKind kind;
+};
+
+static std::vector<counterInfo> counterInfos_;	// indexed by ID
+static std::unordered_map<std::string, unsigned> mapCounterNameToId_;
+
+std::atomic<double> Counters::gauges_[Counters::slotCount];
+std::mutex Counters::mutex_;
+std::vector<std::shared_ptr<Counters::threadSlots>> Counters::allThreadSlots_;
+std::vector<int64_t> Counters::lastTotals_;
+std::vector<double> Counters::lastFrameValues_;
+std::deque<Counters::frameSnapshot> Counters::history_;
+unsigned Counters::historySize_ = 600;
+
+unsigned registerCounter(const char name[], CounterKind kind) {
+	std::lock_guard<std::mutex> lk(Counters::mutex_);
+	auto it = mapCounterNameToId_.find(name);
+	if (it != mapCounterNameToId_.end()) {
+		assertDbg(counterInfos_[it->second].kind == kind && "Counter registered again with a different kind");
+		return it->second;
+	}
+	if (counterInfos_.size() >= Counters::maxCounters) {
+		ERROR("perf::registerCounter: too many counters, \"" << name << "\" will not be reported");
+		return Counters::maxCounters;
+	}
+	unsigned id = counterInfos_.size();
+	counterInfos_.push_back({name, kind});
+	mapCounterNameToId_.emplace(name, id);
+	Counters::gauges_[id].store(0, std::memory_order_relaxed);
+	return id;
+}
+
+Counters::threadSlots* Counters::createThreadSlots() {
+	// the slots are owned by the registry so the counts survive the thread
+	auto slots = std::make_shared<threadSlots>();
+	std::lock_guard<std::mutex> lk(mutex_);
+	allThreadSlots_.push_back(slots);
+	return slots.get();
+}
+
+void Counters::frameBoundary() {
+	std::lock_guard<std::mutex> lk(mutex_);
+	unsigned n = counterInfos_.size();
+	lastTotals_.resize(n, 0);
+	lastFrameValues_.resize(n, 0);
+	for (unsigned i=0; i<n; i++) {
+		if (counterInfos_[i].kind == CounterKind::Gauge) {
+			lastFrameValues_[i] = gauges_[i].load(std::memory_order_relaxed);
+			continue;
+		}
+		int64_t total = 0;
+		for (auto &s : allThreadSlots_)
+			total += s->values_[i].load(std::memory_order_relaxed);
+		lastFrameValues_[i] = total - lastTotals_[i];
+		lastTotals_[i] = total;
+	}
+	history_.push_back({Clock::now(), lastFrameValues_});
+	while (history_.size() > historySize_)
+		history_.pop_front();
+}
+
+std::vector<CounterValue> Counters::getSnapshot() {
+	std::lock_guard<std::mutex> lk(mutex_);
+	std::vector<CounterValue> ret;
+	for (unsigned i=0; i<lastFrameValues_.size(); i++) {
+		auto kind = counterInfos_[i].kind;
+		ret.push_back({counterInfos_[i].name, kind, lastFrameValues_[i],
+			kind == CounterKind::Gauge ? lastFrameValues_[i] : (double)lastTotals_[i]});
+	}
+	return ret;
+}
+
+double Counters::getLastFrameValue(unsigned id) {
+	std::lock_guard<std::mutex> lk(mutex_);
+	return id < lastFrameValues_.size() ? lastFrameValues_[id] : 0;
+}
+
+double Counters::getLastFrameValue(std::string const& name) {
+	std::lock_guard<std::mutex> lk(mutex_);
+	auto it = mapCounterNameToId_.find(name);
+	if (it == mapCounterNameToId_.end() || it->second >= lastFrameValues_.size())
+		return 0;
+	return lastFrameValues_[it->second];
+}
+
+void Counters::setHistorySize(unsigned frames) {
+	std::lock_guard<std::mutex> lk(mutex_);
+	historySize_ = frames;
+}
+
+std::vector<TraceCounterSample> Counters::getTraceSamples(Clock::time_point since, Clock::time_point origin) {
+	std::lock_guard<std::mutex> lk(mutex_);
+	std::vector<TraceCounterSample> ret;
+	for (auto &snapshot : history_) {
+		if (snapshot.time < since)
+			continue;
+		uint64_t t = snapshot.time > origin ? std::chrono::nanoseconds(snapshot.time - origin).count() : 0;
+		for (unsigned i=0; i<snapshot.values.size(); i++)
+			ret.push_back({counterInfos_[i].name, t, snapshot.values[i]});
+	}
+	return ret;
+}
+
+} /* namespace perf */
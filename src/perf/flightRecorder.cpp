@@ -0,0 +1,86 @@
+/*
+ * flightRecorder.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/perf/flightRecorder.h>
+#include <boglfw/perf/frameCapture.h>
+#include <boglfw/perf/traceExport.h>
+#include <boglfw/perf/counters.h>
+#include <boglfw/utils/log.h>
+
+#include <sstream>
+
+namespace perf {
+
+FlightRecorderConfig FlightRecorder::config_;
+bool FlightRecorder::running_ = false;
+std::deque<uint64_t> FlightRecorder::frameStarts_;
+uint64_t FlightRecorder::windowStart_ = 0;
+unsigned FlightRecorder::dumpCountdown_ = 0;
+unsigned FlightRecorder::dumpCount_ = 0;
+std::thread FlightRecorder::writerThread_;
+
+void FlightRecorder::start(FlightRecorderConfig const& config) {
+	assertDbg(!running_ && "Flight recorder already running!");
+	config_ = config;
+	frameStarts_.clear();
+	dumpCountdown_ = 0;
+	dumpCount_ = 0;
+	FrameCapture::cleanup();	// records left over from an earlier capture would end up in the first dump
+	FrameCapture::start(FrameCapture::AllThreads);
+	frameStarts_.push_back(FrameCapture::getCaptureTime());
+	running_ = true;
+}
+
+void FlightRecorder::stop() {
+	if (!running_)
+		return;
+	running_ = false;
+	FrameCapture::stop();
+	if (writerThread_.joinable())
+		writerThread_.join();
+	FrameCapture::cleanup();
+}
+
+void FlightRecorder::frameBoundary() {
+	if (!running_)
+		return;
+	uint64_t now = FrameCapture::getCaptureTime();
+	uint64_t frameDuration = now - frameStarts_.back();
+	frameStarts_.push_back(now);
+	while (frameStarts_.size() > config_.framesBefore + 2)	// the spiking frame's start and end + framesBefore
+		frameStarts_.pop_front();
+
+	if (dumpCountdown_ > 0) {
+		if (--dumpCountdown_ == 0)
+			dump();
+		return;
+	}
+	if (dumpCount_ < config_.maxDumps && frameDuration > config_.spikeThresholdMs * 1.e6f) {
+		LOGPREFIX("FlightRecorder");
+		LOGLN("Frame spike detected: " << frameDuration / 1000000.f << " ms");
+		windowStart_ = frameStarts_.front();
+		dumpCountdown_ = config_.framesAfter;
+		if (dumpCountdown_ == 0)
+			dump();
+	}
+}
+
+void FlightRecorder::dump() {
+	// copying the records is quick, but writing them isn't - do that on a separate thread so it doesn't cause another spike
+	auto data = FrameCapture::getSnapshot(windowStart_);
+	auto captureStart = FrameCapture::getCaptureStartTime();
+	auto counters = Counters::getTraceSamples(captureStart + std::chrono::nanoseconds(windowStart_), captureStart);
+	std::stringstream path;
+	path << config_.outputPrefix << dumpCount_++ << ".json";
+	if (writerThread_.joinable())
+		writerThread_.join();
+	writerThread_ = std::thread([] (std::vector<FrameCapture::frameData> data, std::vector<TraceCounterSample> counters, std::string path) {
+		exportChromeTrace(data, path, counters);
+	}, std::move(data), std::move(counters), path.str());
+}
+
+} /* namespace perf */
@@ -13,29 +13,33 @@ namespace perf {
 
 std::atomic<FrameCapture::CaptureMode> FrameCapture::mode_ {FrameCapture::Disabled};
 std::atomic<std::thread::id> FrameCapture::exclusiveThreadID_;
-MTVector<std::shared_ptr<std::vector<FrameCapture::frameData>>> FrameCapture::allFrames_ {8};
-MTVector<std::string> FrameCapture::threadNames_ {8};
-std::chrono::time_point<std::chrono::high_resolution_clock> FrameCapture::captureStartTime_;
-#ifdef DEBUG_INSTANCES
-MTVector<FrameCapture*> FrameCapture::allInstances_ {8};
-#endif
+std::atomic<size_t> FrameCapture::bufferCapacity_ { 1 << 16 };
+std::atomic<unsigned> FrameCapture::generation_ { 0 };
+MTVector<std::shared_ptr<FrameCapture::threadBuffer>> FrameCapture::allFrames_ {8, nullptr};	// perf containers use unprofiled locks
+MTVector<std::string> FrameCapture::threadNames_ {8, nullptr};
+Clock::time_point FrameCapture::captureStartTime_;
 
 void FrameCapture::start(FrameCapture::CaptureMode mode) {
 	assertDbg(mode_.load(std::memory_order_acquire) == Disabled && "Capture already in progress!");
 	if (mode == ThisThreadOnly)
 		exclusiveThreadID_.store(std::this_thread::get_id(), std::memory_order_release);
-	captureStartTime_ = std::chrono::high_resolution_clock::now();
+	generation_.fetch_add(1, std::memory_order_relaxed);
+	captureStartTime_ = Clock::now();
 	mode_.store(mode, std::memory_order_release);
 }
 
 void FrameCapture::stop() {
 	mode_.store(Disabled, std::memory_order_release);
-	// check all unfinished frames
-	auto now = std::chrono::high_resolution_clock::now();
-	for (auto &tf : allFrames_)
-		for (auto &f : *tf)
-			if (f.endTime_.time_since_epoch().count() == 0)
-				f.endTime_ = now;
+	// close all unfinished frames
+	uint64_t now = std::chrono::nanoseconds(Clock::now() - captureStartTime_).count();
+	for (auto &buf : allFrames_) {
+		uint64_t n = std::min<uint64_t>(buf->writeSeq_.load(std::memory_order_acquire), buf->capacity_);
+		for (uint64_t i=0; i<n; i++) {
+			auto &f = buf->records_[i];
+			if (f.durationNanosec_ == openDuration)
+				f.durationNanosec_ = now > f.startNanosec_ ? now - f.startNanosec_ : 0;
+		}
+	}
 }
 
 std::string FrameCapture::getThreadNameForIndex(unsigned index) {
@@ -46,21 +50,63 @@ std::string FrameCapture::getThreadNameForIndex(unsigned index) {
 std::vector<FrameCapture::frameData> FrameCapture::getResults() {
 	assertDbg(mode_.load(std::memory_order_acquire) == Disabled && "Don't call this while capturing!!!");
 	std::vector<FrameCapture::frameData> ret;
-	for (auto &fv : allFrames_) {
-		assert (fv != nullptr);
-		// fv->getContentsExclusive(ret);
-		std::copy(fv->begin(), fv->end(), std::back_inserter(ret));
+	for (auto &buf : allFrames_) {
+		assert (buf != nullptr);
+		uint64_t end = buf->writeSeq_.load(std::memory_order_acquire);
+		uint64_t begin = end > buf->capacity_ ? end - buf->capacity_ : 0;
+		for (uint64_t seq = begin; seq < end; seq++)
+			ret.push_back(buf->records_[seq % buf->capacity_]);
 	}
 	std::sort(ret.begin(), ret.end(), [] (auto &x, auto &y) {
-		return x.startTime_ < y.startTime_;
+		return x.startNanosec_ < y.startNanosec_;
 	});
 	return ret;
 }
 
+std::vector<FrameCapture::frameData> FrameCapture::getSnapshot(uint64_t fromNanosec) {
+	std::vector<FrameCapture::frameData> ret;
+	uint64_t now = getCaptureTime();
+	for (auto &buf : allFrames_.getContentsExclusive()) {
+		// the owner thread keeps writing while we copy; any record it may have touched in the mean time
+		// (its sequence number falls out of the ring window after the copy) is discarded. That includes the slot
+		// of record #endAfter, which the owner fills before publishing it and which may be half written.
+		// The only other thing it may change concurrently is the duration of an open record, which is a single word.
+		uint64_t end = buf->writeSeq_.load(std::memory_order_acquire);
+		uint64_t begin = end > buf->capacity_ ? end - buf->capacity_ : 0;
+		size_t firstNew = ret.size();
+		for (uint64_t seq = begin; seq < end; seq++)
+			ret.push_back(buf->records_[seq % buf->capacity_]);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint64_t endAfter = buf->writeSeq_.load(std::memory_order_relaxed);
+		uint64_t validBegin = endAfter + 1 > buf->capacity_ ? endAfter + 1 - buf->capacity_ : 0;
+		if (validBegin > begin) {
+			size_t dropCount = std::min<uint64_t>(validBegin - begin, end - begin);
+			ret.erase(ret.begin() + firstNew, ret.begin() + firstNew + dropCount);
+		}
+	}
+	for (auto &f : ret)
+		if (f.durationNanosec_ == openDuration)
+			f.durationNanosec_ = now > f.startNanosec_ ? now - f.startNanosec_ : 0;
+	ret.erase(std::remove_if(ret.begin(), ret.end(), [fromNanosec] (auto &f) {
+		return f.getEndNanosec() < fromNanosec;
+	}), ret.end());
+	std::sort(ret.begin(), ret.end(), [] (auto &x, auto &y) {
+		return x.startNanosec_ < y.startNanosec_;
+	});
+	return ret;
+}
+
+std::map<unsigned, LatencyHistogram> FrameCapture::getSectionHistograms(std::vector<frameData> const& data) {
+	std::map<unsigned, LatencyHistogram> ret;
+	for (auto &f : data)
+		ret[f.nameId_].record(f.durationNanosec_);
+	return ret;
+}
+
 void FrameCapture::cleanup() {
 	assertDbg(mode_ == Disabled && "Don't call this while capturing!!!");
-	for (auto &fv : allFrames_) {
-		fv->clear();
+	for (auto &buf : allFrames_) {
+		buf->writeSeq_.store(0, std::memory_order_release);
 	}
 }
 
@@ -0,0 +1,46 @@
+/*
+ * marker.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/perf/marker.h>
+
+#include <mutex>
+
+namespace perf {
+
+#ifdef ENABLE_PERF_MARKERS
+static bool markersEnabled_ = true;
+std::atomic<unsigned> detail::enabledMarkerCategories_ { MarkerCategory::All };
+#else
+static bool markersEnabled_ = false;
+std::atomic<unsigned> detail::enabledMarkerCategories_ { 0 };
+#endif
+static unsigned categoryMask_ = MarkerCategory::All;
+static std::mutex switchMutex_;	// keeps the two switches and their combination in enabledMarkerCategories_ consistent
+
+void setMarkersEnabled(bool enabled) {
+	std::lock_guard<std::mutex> lk(switchMutex_);
+	markersEnabled_ = enabled;
+	detail::enabledMarkerCategories_.store(markersEnabled_ ? categoryMask_ : 0, std::memory_order_relaxed);
+}
+
+bool getMarkersEnabled() {
+	std::lock_guard<std::mutex> lk(switchMutex_);
+	return markersEnabled_;
+}
+
+void setEnabledMarkerCategories(unsigned categoryMask) {
+	std::lock_guard<std::mutex> lk(switchMutex_);
+	categoryMask_ = categoryMask;
+	detail::enabledMarkerCategories_.store(markersEnabled_ ? categoryMask_ : 0, std::memory_order_relaxed);
+}
+
+unsigned getEnabledMarkerCategories() {
+	std::lock_guard<std::mutex> lk(switchMutex_);
+	return categoryMask_;
+}
+
+} /* namespace perf */
@@ -11,6 +11,7 @@
 #include <thread>
 #include <chrono>
 #include <sstream>
+#include <iomanip>
 #include <iostream>
 #include <algorithm>
 #include <map>
@@ -56,7 +57,15 @@ void printCallFrame(perf::sectionData const& s, bool flatMode/*=false*/) {
 				<< formatTime(s.getExclusiveNanosec()) << ioModif::FG_DEFAULT << " | ";
 	std::cout << "avg-inc " << formatTime(s.getInclusiveNanosec() / s.getExecutionCount()) << " | ";
 	if (!flatMode)
-		std::cout << "avg-exc " << formatTime(s.getExclusiveNanosec() / s.getExecutionCount());
+		std::cout << "avg-exc " << formatTime(s.getExclusiveNanosec() / s.getExecutionCount()) << " | ";
+	std::cout << "p50 " << formatTime(s.getPercentileNanosec(50)) << " | "
+		<< "p90 " << formatTime(s.getPercentileNanosec(90)) << " | "
+		<< "p99 " << ioModif::FG_LIGHT_GREEN << formatTime(s.getPercentileNanosec(99)) << ioModif::FG_DEFAULT << " | "
+		<< "max " << formatTime(s.getMaxNanosec());
+	if (s.getThreadCount() > 1)
+		std::cout << " | threads " << s.getThreadCount() << " | imbalance "
+			<< (s.getThreadImbalance() > 1.5f ? ioModif::FG_RED : ioModif::FG_DEFAULT)
+			<< std::setprecision(2) << std::fixed << s.getThreadImbalance() << std::defaultfloat << ioModif::FG_DEFAULT;
 	std::cout << "}" << ioModif::RESET;
 }
 
@@ -90,20 +99,20 @@ void printTopHits(std::vector<perf::sectionData> data) {
 }
 
 void dumpFrameCaptureData(std::vector<perf::FrameCapture::frameData> data) {
-	auto referenceTime = data.front().startTime_;
+	auto referenceTime = data.front().startNanosec_;
 	// convert any time point into relative amount of nanoseconds since start of frame
-	auto relativeNano = [referenceTime] (decltype(data[0].startTime_) &pt) -> int64_t {
-		return std::chrono::nanoseconds(pt - referenceTime).count();
+	auto relativeNano = [referenceTime] (uint64_t t) -> int64_t {
+		return t - referenceTime;
 	};
 	for (auto &f : data) {
-		std::cout << "FRAME " << f.name_ << "\n\t" << "thread: " << f.threadIndex_ << "\tstart: "
-				<< relativeNano(f.startTime_)/1000 << "\tend: " << relativeNano(f.endTime_)/1000 << "\n";
+		std::cout << "FRAME " << f.getName() << "\n\t" << "thread: " << f.threadIndex_ << "\tstart: "
+				<< relativeNano(f.startNanosec_)/1000 << "\tend: " << relativeNano(f.getEndNanosec())/1000 << "\n";
 	}
 }
 
 void printFrameCaptureStatistics(std::vector<perf::FrameCapture::frameData> data) {
 	std::cout << "============= FRAME CAPTURE STATS ================\n";
-	std::cout << "Total Frame time: " << formatTime((data.back().endTime_-data.front().startTime_).count()) << "\n";
+	std::cout << "Total Frame time: " << formatTime(data.back().getEndNanosec() - data.front().startNanosec_) << "\n";
 	std::cout << data.size() << " frames total\n";
 	std::map<int, int> framesPerThread;
 	for (auto &f : data)
@@ -114,21 +123,86 @@ void printFrameCaptureStatistics(std::vector<perf::FrameCapture::frameData> data
 	std::cout << "Average frames per thread: " << std::accumulate(framesPerThread.begin(), framesPerThread.end(), 0, [] (int x, auto &p) {
 		return x + p.second;
 	}) / framesPerThread.size() << "\n";
+	std::cout << "Section durations:\n";
+	for (auto &p : perf::FrameCapture::getSectionHistograms(data)) {
+		auto &h = p.second;
+		std::cout << "\t" << perf::getSectionName(p.first) << ": " << h.getCount() << " calls"
+			<< " | p50 " << formatTime(h.getP50()) << " | p90 " << formatTime(h.getP90())
+			<< " | p99 " << formatTime(h.getP99()) << " | max " << formatTime(h.getMax()) << "\n";
+	}
+}
+
+void printTopAllocators(std::vector<perf::AllocationTracker::SectionAllocations> const& data) {
+	for (unsigned i=0; i<data.size(); i++) {
+		std::cout << i << ": " << ioModif::BOLD << ioModif::FG_LIGHT_YELLOW << data[i].name << ioModif::RESET
+			<< "    {allocs " << data[i].count << " | bytes " << data[i].bytes
+			<< " | avg " << data[i].bytes / data[i].count << "}\n";
+	}
+}
+
+static void printBaselineDiffRow(perf::BaselineSectionDiff const& d) {
+	std::cout << (d.regression ? ioModif::FG_RED : d.improvement ? ioModif::FG_LIGHT_GREEN : ioModif::FG_DEFAULT)
+		<< "[" << d.thread << "] " << (d.fromTree ? "tree: " : "") << ioModif::BOLD << d.path << ioModif::NO_BOLD << "    {";
+	if (d.onlyInBase)
+		std::cout << "removed";
+	else if (d.onlyInCurrent)
+		std::cout << "new | avg " << formatTime(d.current.getMeanNanosec());
+	else {
+		int64_t change = (int64_t)d.absoluteChangeNanosec;
+		std::cout << "avg " << formatTime(d.base.getMeanNanosec()) << " -> " << formatTime(d.current.getMeanNanosec())
+			<< " | " << (change < 0 ? "-" : "+") << formatTime(std::abs(change))
+			<< " (" << std::showpos << std::setprecision(1) << std::fixed << d.relativeChange * 100 << "%" << std::noshowpos << ")"
+			<< " | p99 " << formatTime(d.base.p99) << " -> " << formatTime(d.current.p99)
+			<< " | t " << std::setprecision(1) << d.tScore << std::defaultfloat;
+	}
+	std::cout << "}" << ioModif::RESET << "\n";
+}
+
+void printBaselineDiff(std::vector<perf::BaselineSectionDiff> const& diff, unsigned maxRows) {
+	auto ranked = diff;
+	std::cout << "Largest absolute changes:\n";
+	perf::sortBaselineDiff(ranked, perf::BaselineDiffRanking::AbsoluteChange);
+	for (unsigned i=0; i<ranked.size() && i<maxRows; i++)
+		printBaselineDiffRow(ranked[i]);
+	std::cout << "Largest relative changes:\n";
+	perf::sortBaselineDiff(ranked, perf::BaselineDiffRanking::RelativeChange);
+	for (unsigned i=0; i<ranked.size() && i<maxRows; i++)
+		printBaselineDiffRow(ranked[i]);
+	unsigned regressions = 0, improvements = 0;
+	for (auto &d : diff) {
+		regressions += d.regression;
+		improvements += d.improvement;
+	}
+	std::cout << (regressions ? ioModif::FG_RED : ioModif::FG_DEFAULT) << regressions << " significant regressions" << ioModif::RESET
+		<< ", " << improvements << " significant improvements\n";
+}
+
+void printLockStats(std::vector<perf::LockStats> const& stats) {
+	for (auto &l : stats) {
+		if (!l.acquisitions)
+			continue;
+		std::cout << (l.contentions ? ioModif::FG_LIGHT_YELLOW : ioModif::FG_DEFAULT) << ioModif::BOLD << l.name << ioModif::NO_BOLD
+			<< "    {acquired " << l.acquisitions << " | contended " << l.contentions
+			<< " (" << std::setprecision(1) << std::fixed << 100.0 * l.contentions / l.acquisitions << "%)" << std::defaultfloat
+			<< " | wait " << formatTime(l.waitNanosec) << " (max " << formatTime(l.maxWaitNanosec) << ")"
+			<< " | held " << formatTime(l.holdNanosec) << " (avg " << formatTime(l.holdNanosec / l.acquisitions) << ")"
+			<< "}" << ioModif::RESET << "\n";
+	}
 }
 
 void printFrameCaptureData(std::vector<perf::FrameCapture::frameData> data) {
 	//dumpFrameCaptureData(data);
 	printFrameCaptureStatistics(data);
-	auto referenceTime = data.front().startTime_;
+	auto referenceTime = data.front().startNanosec_;
 	// convert any time point into relative amount of nanoseconds since start of frame
-	auto relativeNano = [referenceTime] (decltype(data[0].startTime_) &pt) -> int64_t {
-		return std::chrono::nanoseconds(pt - referenceTime).count();
+	auto relativeNano = [referenceTime] (uint64_t t) -> int64_t {
+		return t - referenceTime;
 	};
 	// compute metrics:
 	auto lastFrame = std::max_element(data.begin(), data.end(), [] (perf::FrameCapture::frameData const& d1, perf::FrameCapture::frameData const& d2) {
-		return d1.endTime_ < d2.endTime_;
+		return d1.getEndNanosec() < d2.getEndNanosec();
 	});
-	int64_t timeSpan = relativeNano(lastFrame->endTime_);
+	int64_t timeSpan = relativeNano(lastFrame->getEndNanosec());
 #ifndef __WIN32__
 	struct winsize sz;
 	ioctl(STDOUT_FILENO,TIOCGWINSZ,&sz);
@@ -172,18 +246,19 @@ void printFrameCaptureData(std::vector<perf::FrameCapture::frameData> data) {
 			threads.push_back(threadData());
 		threadData &td = threads[f.threadIndex_];
 		// see if this frame appeared before in this thread:
-		if (td.legend.find(f.name_) == td.legend.end())
-			td.legend.insert({f.name_, td.legend.size()});
+		std::string name = f.getName();
+		if (td.legend.find(name) == td.legend.end())
+			td.legend.insert({name, td.legend.size()});
 		// check if need to pop a stack level
-		while (td.callsEndTime.size() >= 2 && *(td.callsEndTime.end()-2) < relativeNano(f.endTime_))
+		while (td.callsEndTime.size() >= 2 && *(td.callsEndTime.end()-2) < relativeNano(f.getEndNanosec()))
 			td.callsEndTime.pop_back();
 		// check if this is a new level on the stack
-		if (td.callsEndTime.empty() || relativeNano(f.endTime_) < td.callsEndTime.back())
-			td.callsEndTime.push_back(relativeNano(f.endTime_));
+		if (td.callsEndTime.empty() || relativeNano(f.getEndNanosec()) < td.callsEndTime.back())
+			td.callsEndTime.push_back(relativeNano(f.getEndNanosec()));
 		else {
-			td.callsEndTime.back() = relativeNano(f.endTime_);
+			td.callsEndTime.back() = relativeNano(f.getEndNanosec());
 		}
-		int frameID = td.legend[f.name_];
+		int frameID = td.legend[name];
 		while (td.str.size() < td.callsEndTime.size()) {
 			td.str.push_back(std::make_unique<std::stringstream>());
 			td.strOffs.push_back(0);
@@ -191,8 +266,8 @@ void printFrameCaptureData(std::vector<perf::FrameCapture::frameData> data) {
 		auto& crtStr = *td.str[td.callsEndTime.size()-1];
 		auto& crtStrOffs = td.strOffs[td.callsEndTime.size()-1];
 		// add spaces before this call:
-		int startOffs = relativeNano(f.startTime_) * cellsPerNanosec;
-		int endOffs = relativeNano(f.endTime_) * cellsPerNanosec;
+		int startOffs = relativeNano(f.startNanosec_) * cellsPerNanosec;
+		int endOffs = relativeNano(f.getEndNanosec()) * cellsPerNanosec;
 		int spaceCells = max(0, startOffs - crtStrOffs);
 		crtStr << std::string(spaceCells, ' ');
 		crtStrOffs += spaceCells;
@@ -0,0 +1,114 @@
+/*
+ * profiledMutex.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/perf/profiledMutex.h>
+#include <boglfw/perf/marker.h>
+
+#include <deque>
+#include <unordered_map>
+#include <algorithm>
+#include <tuple>
+
+namespace perf {
+
+struct lockRegistry {
+	std::mutex mutex;
+	std::deque<std::pair<std::string, ProfiledMutex::namedStats>> stats;	// deque keeps the addresses stable
+	std::unordered_map<std::string, ProfiledMutex::namedStats*> mapNameToStats;
+};
+
+namespace {
+	// function-local so that locks defined at namespace scope (the logger's) can register during static initialization
+	lockRegistry& getRegistry() {
+		static lockRegistry registry;
+		return registry;
+	}
+
+	// set while a contended lock records its wait section, so that a lock taken
+	// from within the perf module during that time doesn't record another one
+	thread_local bool recordingWait_ = false;
+}
+
+ProfiledMutex::ProfiledMutex(const char name[])
+	: name_(name) {
+	if (!name)
+		return;
+	auto &reg = getRegistry();
+	std::lock_guard<std::mutex> lk(reg.mutex);
+	auto it = reg.mapNameToStats.find(name);
+	if (it != reg.mapNameToStats.end()) {
+		stats_ = it->second;
+	} else {
+		reg.stats.emplace_back(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple());
+		stats_ = &reg.stats.back().second;
+		reg.mapNameToStats[name] = stats_;
+	}
+}
+
+void ProfiledMutex::lockContended() {
+	auto start = Clock::now();
+	if (recordingWait_) {
+		mutex_.lock();
+	} else {
+		if (!stats_->waitSectionValid.load(std::memory_order_acquire)) {
+			// racing threads intern the same name and get the same ID
+			stats_->waitSectionId = internSectionName((std::string("lock-wait: ") + name_).c_str());
+			stats_->waitSectionValid.store(true, std::memory_order_release);
+		}
+		recordingWait_ = true;
+		{
+			Marker waitMarker(stats_->waitSectionId, true, MarkerCategory::Threading);
+			mutex_.lock();
+		}
+		recordingWait_ = false;
+	}
+	uint64_t wait = std::chrono::nanoseconds(Clock::now() - start).count();
+	stats_->contentions.fetch_add(1, std::memory_order_relaxed);
+	stats_->waitNanosec.fetch_add(wait, std::memory_order_relaxed);
+	// other instances with the same name may update the max concurrently
+	uint64_t prevMax = stats_->maxWaitNanosec.load(std::memory_order_relaxed);
+	while (wait > prevMax && !stats_->maxWaitNanosec.compare_exchange_weak(prevMax, wait, std::memory_order_relaxed))
+		;
+}
+
+std::vector<LockStats> ProfiledMutex::getStats() {
+	auto &reg = getRegistry();
+	std::vector<LockStats> ret;
+	{
+		std::lock_guard<std::mutex> lk(reg.mutex);
+		for (auto &p : reg.stats) {
+			auto &s = p.second;
+			ret.push_back(LockStats {
+				p.first,
+				s.acquisitions.load(std::memory_order_relaxed),
+				s.contentions.load(std::memory_order_relaxed),
+				s.waitNanosec.load(std::memory_order_relaxed),
+				s.maxWaitNanosec.load(std::memory_order_relaxed),
+				s.holdNanosec.load(std::memory_order_relaxed)
+			});
+		}
+	}
+	std::sort(ret.begin(), ret.end(), [] (auto &a, auto &b) {
+		return a.waitNanosec > b.waitNanosec;
+	});
+	return ret;
+}
+
+void ProfiledMutex::resetStats() {
+	auto &reg = getRegistry();
+	std::lock_guard<std::mutex> lk(reg.mutex);
+	for (auto &p : reg.stats) {
+		auto &s = p.second;
+		s.acquisitions.store(0, std::memory_order_relaxed);
+		s.contentions.store(0, std::memory_order_relaxed);
+		s.waitNanosec.store(0, std::memory_order_relaxed);
+		s.maxWaitNanosec.store(0, std::memory_order_relaxed);
+		s.holdNanosec.store(0, std::memory_order_relaxed);
+	}
+}
+
+} // namespace perf
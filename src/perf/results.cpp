@@ -12,7 +12,7 @@
 
 namespace perf {
 
-MTVector<std::shared_ptr<CallGraph>> Results::threadGraphs_ { 16 };
+MTVector<std::shared_ptr<CallGraph>> Results::threadGraphs_ { 16, nullptr };	// perf containers use unprofiled locks
 
 std::string Results::getThreadName(unsigned id) {
 	if (id > threadGraphs_.size())
@@ -40,7 +40,8 @@ std::vector<sectionData> Results::getFlatList(unsigned threadID) {
 		return {};
 	std::vector<sectionData> ret;
 	for (auto &p : threadGraphs_[threadID]->flatSectionData_)
-		ret.push_back(*p.second);
+		if (p)
+			ret.push_back(*p);
 	return ret;
 }
 
@@ -51,5 +52,96 @@ std::vector<sectionData> Results::getFlatList(std::string const& threadName) {
 	return {};
 }
 
+std::vector<std::string> Results::getThreadNames() {
+	std::vector<std::string> ret;
+	for (unsigned i=0; i<threadGraphs_.size(); i++)
+		if (std::find(ret.begin(), ret.end(), threadGraphs_[i]->threadName_) == ret.end())
+			ret.push_back(threadGraphs_[i]->threadName_);
+	return ret;
+}
+
+std::shared_ptr<sectionData> Results::makeMergedSection(unsigned id) {
+	auto ret = sectionData::make_shared(id);
+	ret->threadCount_ = 0;
+	return ret;
+}
+
+void Results::mergeSection(sectionData &dst, sectionData const& src) {
+	dst.deadTime_ = src.deadTime_;
+	dst.nanoseconds_ += src.nanoseconds_;
+	dst.executionCount_ += src.executionCount_;
+	dst.histogram_.merge(src.histogram_);
+	dst.threadCount_++;
+	dst.maxThreadNanosec_ = std::max(dst.maxThreadNanosec_, src.nanoseconds_);
+	for (unsigned i=0; i<src.callees_.size(); i++) {
+		auto it = std::find(dst.calleeIds_.begin(), dst.calleeIds_.end(), src.calleeIds_[i]);
+		if (it == dst.calleeIds_.end()) {
+			dst.callees_.push_back(makeMergedSection(src.calleeIds_[i]));
+			dst.calleeIds_.push_back(src.calleeIds_[i]);
+			it = dst.calleeIds_.end() - 1;
+		}
+		mergeSection(*dst.callees_[it - dst.calleeIds_.begin()], *src.callees_[i]);
+	}
+}
+
+std::vector<std::shared_ptr<sectionData>> Results::getMergedCallTrees(std::string const& threadName) {
+	std::vector<std::shared_ptr<sectionData>> ret;
+	std::vector<unsigned> retIds;
+	for (unsigned i=0; i<threadGraphs_.size(); i++) {
+		auto &graph = *threadGraphs_[i];
+		if (graph.threadName_ != threadName)
+			continue;
+		for (unsigned k=0; k<graph.rootTrees_.size(); k++) {
+			auto it = std::find(retIds.begin(), retIds.end(), graph.rootTreeIds_[k]);
+			if (it == retIds.end()) {
+				ret.push_back(makeMergedSection(graph.rootTreeIds_[k]));
+				retIds.push_back(graph.rootTreeIds_[k]);
+				it = retIds.end() - 1;
+			}
+			mergeSection(*ret[it - retIds.begin()], *graph.rootTrees_[k]);
+		}
+	}
+	return ret;
+}
+
+std::vector<sectionData> Results::getMergedFlatList(std::string const& threadName) {
+	std::vector<std::unique_ptr<sectionData>> merged;	// indexed by section ID
+	for (unsigned i=0; i<threadGraphs_.size(); i++) {
+		auto &graph = *threadGraphs_[i];
+		if (graph.threadName_ != threadName)
+			continue;
+		for (auto &p : graph.flatSectionData_) {
+			if (!p)
+				continue;
+			if (p->id_ >= merged.size())
+				merged.resize(p->id_ + 1);
+			if (!merged[p->id_]) {
+				merged[p->id_] = sectionData::make_unique(p->id_);
+				merged[p->id_]->threadCount_ = 0;
+			}
+			mergeSection(*merged[p->id_], *p);
+		}
+	}
+	std::vector<sectionData> ret;
+	for (auto &p : merged)
+		if (p)
+			ret.push_back(*p);
+	return ret;
+}
+
+LatencyHistogram Results::getMergedHistogram(unsigned sectionId) {
+	LatencyHistogram ret;
+	for (unsigned i=0; i<threadGraphs_.size(); i++) {
+		auto &flatList = threadGraphs_[i]->flatSectionData_;
+		if (sectionId < flatList.size() && flatList[sectionId])
+			ret.merge(flatList[sectionId]->getHistogram());
+	}
+	return ret;
+}
+
+LatencyHistogram Results::getMergedHistogram(std::string const& sectionName) {
+	return getMergedHistogram(internSectionName(sectionName.c_str()));
+}
+
 } // namespace perf
 
@@ -0,0 +1,41 @@
+/*
+ * section.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/perf/section.h>
+
+#include <mutex>
+#include <deque>
+#include <unordered_map>
+
+namespace perf {
+
+static std::mutex namesMutex_;
+static std::deque<std::string> names_;	// indexed by ID; deque so existing elements never move
+static std::unordered_map<std::string, unsigned> mapNameToId_;
+
+unsigned internSectionName(const char name[]) {
+	std::lock_guard<std::mutex> lk(namesMutex_);
+	auto it = mapNameToId_.find(name);
+	if (it != mapNameToId_.end())
+		return it->second;
+	unsigned id = names_.size();
+	names_.push_back(name);
+	mapNameToId_.emplace(names_.back(), id);
+	return id;
+}
+
+std::string getSectionName(unsigned id) {
+	std::lock_guard<std::mutex> lk(namesMutex_);
+	return id < names_.size() ? names_[id] : std::string("{UNKNOWN}");
+}
+
+unsigned getSectionNameCount() {
+	std::lock_guard<std::mutex> lk(namesMutex_);
+	return names_.size();
+}
+
+} // namespace perf
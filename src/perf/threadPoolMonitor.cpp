@@ -0,0 +1,62 @@
+/*
+ * threadPoolMonitor.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/perf/threadPoolMonitor.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace perf {
+
+ThreadPoolMonitor::ThreadPoolMonitor(ThreadPool &pool)
+	: pool_(pool)
+	, waitHistogram_(ThreadPool::waitHistogramBuckets, 0) {
+	pool_.resetStats();
+	pool_.setInstrumentationEnabled(true);
+}
+
+ThreadPoolMonitor::~ThreadPoolMonitor() {
+	pool_.setInstrumentationEnabled(false);
+}
+
+void ThreadPoolMonitor::update(float dt) {
+	lastStats_ = pool_.getStats();
+	pool_.resetStats();
+
+	uint64_t totalBusy = 0, totalIdle = 0, maxBusy = 0, tasks = 0;
+	std::fill(waitHistogram_.begin(), waitHistogram_.end(), 0);
+	for (auto &w : lastStats_.workers) {
+		totalBusy += w.busyNanosec;
+		totalIdle += w.idleNanosec;
+		maxBusy = std::max(maxBusy, w.busyNanosec);
+		tasks += w.tasksExecuted;
+		for (unsigned b=0; b<ThreadPool::waitHistogramBuckets; b++)
+			waitHistogram_[b] += w.waitHistogram[b];
+	}
+	utilization_ = totalBusy + totalIdle ? (float)totalBusy / (totalBusy + totalIdle) : 0.f;
+	float avgBusy = lastStats_.workers.empty() ? 0.f : (float)totalBusy / lastStats_.workers.size();
+	imbalance_ = avgBusy > 0 ? maxBusy / avgBusy : 0.f;
+	tasksPerSecond_ = dt > 0 ? tasks / dt : 0.f;
+	avgQueueDepth_ = lastStats_.queueDepthSamples ? (float)lastStats_.queueDepthSum / lastStats_.queueDepthSamples : 0.f;
+	maxQueueDepth_ = lastStats_.queueDepthMax;
+}
+
+float ThreadPoolMonitor::getWaitPercentile(float percentile) const {
+	uint64_t total = std::accumulate(waitHistogram_.begin(), waitHistogram_.end(), (uint64_t)0);
+	if (total == 0)
+		return 0.f;
+	uint64_t threshold = (uint64_t)(total * percentile / 100.f);
+	uint64_t count = 0;
+	for (unsigned b=0; b<waitHistogram_.size(); b++) {
+		count += waitHistogram_[b];
+		if (count > threshold || count == total)
+			return (float)((uint64_t)2 << b) / 1000.f;	// upper bound of the bucket
+	}
+	return 0.f;
+}
+
+} // namespace perf
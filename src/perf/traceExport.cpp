@@ -0,0 +1,125 @@
+/*
+ * traceExport.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/perf/traceExport.h>
+#include <boglfw/utils/log.h>
+
+#include <fstream>
+#include <set>
+#include <cstdio>
+#include <cmath>
+
+namespace perf {
+
+static void writeJsonString(std::ostream &out, std::string const& str) {
+	out << '"';
+	for (char c : str) {
+		switch (c) {
+		case '"': out << "\\\""; break;
+		case '\\': out << "\\\\"; break;
+		case '\n': out << "\\n"; break;
+		case '\t': out << "\\t"; break;
+		default:
+			if ((unsigned char)c < 0x20) {
+				char buf[8];
+				snprintf(buf, sizeof(buf), "\\u%04x", c);
+				out << buf;
+			} else
+				out << c;
+		}
+	}
+	out << '"';
+}
+
+// trace timestamps are in microseconds; keep the nanosecond precision as decimals
+static void writeMicrosec(std::ostream &out, uint64_t nanosec) {
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%llu.%03u", (unsigned long long)(nanosec / 1000), (unsigned)(nanosec % 1000));
+	out << buf;
+}
+
+// JSON has no nan/inf literals; write those as null so the whole file still parses
+static void writeJsonNumber(std::ostream &out, double value) {
+	if (std::isfinite(value))
+		out << value;
+	else
+		out << "null";
+}
+
+bool exportChromeTrace(std::vector<FrameCapture::frameData> const& data, std::ostream &out,
+		std::vector<TraceCounterSample> const& counters) {
+	constexpr int pid = 1;
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+	bool first = true;
+	auto separator = [&first, &out] {
+		if (!first)
+			out << ",\n";
+		first = false;
+	};
+
+	// thread names first, as metadata events
+	std::set<unsigned> threads;
+	for (auto &f : data)
+		threads.insert(f.threadIndex_);
+	for (unsigned t : threads) {
+		separator();
+		out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid << ",\"tid\":" << t << ",\"args\":{\"name\":";
+		writeJsonString(out, FrameCapture::getThreadNameForIndex(t));
+		out << "}}";
+		separator();
+		out << "{\"ph\":\"M\",\"name\":\"thread_sort_index\",\"pid\":" << pid << ",\"tid\":" << t
+			<< ",\"args\":{\"sort_index\":" << t << "}}";
+	}
+
+	for (auto &f : data) {
+		separator();
+		out << "{\"ph\":\"X\",\"name\":";
+		writeJsonString(out, f.getName());
+		out << ",\"cat\":\"" << (f.deadTime_ ? "blocked" : "active") << "\"";
+		if (f.deadTime_)
+			out << ",\"cname\":\"grey\"";
+		out << ",\"pid\":" << pid << ",\"tid\":" << f.threadIndex_ << ",\"ts\":";
+		writeMicrosec(out, f.startNanosec_);
+		out << ",\"dur\":";
+		writeMicrosec(out, f.durationNanosec_);
+		out << "}";
+		if (!out.good())
+			return false;
+	}
+
+	for (auto &c : counters) {
+		separator();
+		out << "{\"ph\":\"C\",\"name\":";
+		writeJsonString(out, c.name);
+		out << ",\"pid\":" << pid << ",\"ts\":";
+		writeMicrosec(out, c.timeNanosec);
+		out << ",\"args\":{\"value\":";
+		writeJsonNumber(out, c.value);
+		out << "}}";
+	}
+
+	out << "\n]}\n";
+	out.flush();
+	return out.good();
+}
+
+bool exportChromeTrace(std::vector<FrameCapture::frameData> const& data, std::string const& filePath,
+		std::vector<TraceCounterSample> const& counters) {
+	std::ofstream f(filePath);
+	if (!f.is_open()) {
+		ERROR("Could not open \"" << filePath << "\" for writing the trace!");
+		return false;
+	}
+	if (!exportChromeTrace(data, f, counters)) {
+		ERROR("Failed writing trace to \"" << filePath << "\"");
+		return false;
+	}
+	LOGLN("Frame capture trace written to \"" << filePath << "\"");
+	return true;
+}
+
+} /* namespace perf */
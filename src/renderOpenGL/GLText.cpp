@@ -14,6 +14,7 @@
 #include <boglfw/utils/filesystem.h>
 #include <boglfw/utils/assert.h>
 #include <boglfw/utils/log.h>
+#include <boglfw/perf/counters.h>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -27,7 +28,7 @@ using namespace glm;
 static GLText* instance = nullptr;
 bool GLText::disableMipMaps_ = false;
 
-void GLText::init(const char* fontPath) {
+void GLText::init(const char* fontPath, bool headless) {
 	LOGPREFIX("GLText");
 	// load font file and parse properties
 	const std::string kTexture = "texture";
@@ -57,7 +58,7 @@ void GLText::init(const char* fontPath) {
 	auto cols = atoi(opts[kColumns].c_str());
 	auto defaultSize = atoi(opts[kDefaultSize].c_str());
 	char firstChar = opts[kFirstChar][1];
-	instance = new GLText(texturePath.c_str(), rows, cols, firstChar, defaultSize);
+	instance = new GLText(texturePath.c_str(), rows, cols, firstChar, defaultSize, headless);
 }
 
 GLText* GLText::get() {
@@ -69,10 +70,12 @@ void GLText::unload() {
 	delete instance, instance = nullptr;
 }
 
-GLText::GLText(const char * texturePath, int rows, int cols, char firstChar, int defaultSize)
-	: rows_(rows), cols_(cols), firstChar_(firstChar), defaultSize_(defaultSize)
+GLText::GLText(const char * texturePath, int rows, int cols, char firstChar, int defaultSize, bool headless)
+	: rows_(rows), cols_(cols), firstChar_(firstChar), defaultSize_(defaultSize), headless_(headless)
 {
 	cellRatio_ = (float)rows/cols;
+	if (headless)
+		return;
 	// Initialize VAO & VBOs
 	glGenVertexArrays(1, &VAO_);
 	glGenBuffers(1, &posVBO_);
@@ -133,6 +136,8 @@ GLText::GLText(const char * texturePath, int rows, int cols, char firstChar, int
 }
 
 GLText::~GLText() {
+	if (headless_)
+		return;
 	// Delete buffers
 	glDeleteBuffers(1, &posVBO_);
 	glDeleteBuffers(1, &uvVBO_);
@@ -241,6 +246,10 @@ void GLText::print(const std::string &text, glm::vec2 pos, int size, glm::vec4 c
 }
 
 void GLText::flush() {
+	if (headless_) {
+		purgeBuffers();
+		return;
+	}
 	if (!shaderProgram_)
 		return;
 
@@ -263,6 +272,7 @@ void GLText::flush() {
 	glBindBuffer(GL_ARRAY_BUFFER, colorVBO_);
 	glBufferData(GL_ARRAY_BUFFER, colors_.size() * sizeof(colors_[0]), &colors_[0], GL_DYNAMIC_DRAW);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	PERF_COUNTER("bytes-uploaded", vertices_.size() * sizeof(vertices_[0]) + UVs_.size() * sizeof(UVs_[0]) + colors_.size() * sizeof(colors_[0]));
 
 	// Bind shader
 	glUseProgram(shaderProgram_);
@@ -289,13 +299,17 @@ void GLText::flush() {
 		glDrawArrays(GL_TRIANGLES, offset, verticesPerItem_[i]);
 		offset += verticesPerItem_[i];
 	}
+	PERF_COUNTER("draw-calls", nItems);
 
 	glDisable(GL_BLEND);
 	glEnable(GL_DEPTH_TEST);
 	glBindVertexArray(0);
 	glUseProgram(0);
 
-	// purge all cached data:
+	purgeBuffers();
+}
+
+void GLText::purgeBuffers() {
 	vertices_.clear();
 	UVs_.clear();
 	colors_.clear();
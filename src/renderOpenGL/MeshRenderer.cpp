@@ -13,6 +13,7 @@
 #include <boglfw/renderOpenGL/glToolkit.h>
 #include <boglfw/renderOpenGL/RenderHelpers.h>
 #include <boglfw/utils/log.h>
+#include <boglfw/perf/counters.h>
 
 #include <boglfw/utils/assert.h>
 
@@ -124,6 +125,7 @@ void MeshRenderer::flush() {
 		}
 		glDrawElements(drawMode, m.pMesh_->getElementsCount(), GL_UNSIGNED_SHORT, 0);
 		checkGLError("mesh draw");
+		PERF_COUNTER("draw-calls", 1);
 		glBindVertexArray(0);
 		if (m.pMesh_->getRenderMode() == Mesh::RENDER_MODE_TRIANGLES_WIREFRAME || m.pMesh_->getRenderMode() == Mesh::RENDER_MODE_LINES) {
 			glLineWidth(1.f);
@@ -6,6 +6,7 @@
 #include <boglfw/renderOpenGL/RenderHelpers.h>
 #include <boglfw/utils/log.h>
 #include <boglfw/perf/marker.h>
+#include <boglfw/perf/counters.h>
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -104,6 +105,7 @@ void PictureDraw::flush() {
 	glBindBuffer(GL_ARRAY_BUFFER, pRenderData->VBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(PictureVertex) * verts_.size(), &verts_[0], GL_DYNAMIC_DRAW);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	PERF_COUNTER("bytes-uploaded", sizeof(PictureVertex) * verts_.size());
 
 	glUseProgram(pRenderData->program);
 	glEnable(GL_BLEND);
@@ -136,6 +138,7 @@ void PictureDraw::flush() {
 		unsigned vOffs = i * 4;
 		glDrawArrays(GL_TRIANGLE_STRIP, vOffs, 4);
 	}
+	PERF_COUNTER("draw-calls", attribs_.size());
 
 	glBindVertexArray(0);
 	glBindTexture(GL_TEXTURE_2D, 0);
@@ -10,6 +10,12 @@ Viewport* RenderHelpers::pActiveViewport = nullptr;
 RenderHelpers::Config RenderHelpers::config_;
 
 void RenderHelpers::load(Config config) {
+	if (config.headless) {
+		// only the helpers that build their geometry on the CPU can work without GL
+		config.disableShape3D = true;
+		config.disableMeshRenderer = true;
+		config.disablePictureDraw = true;
+	}
 	config_ = config;
 
 	if (!config.disableShape3D)
@@ -17,9 +23,9 @@ void RenderHelpers::load(Config config) {
 	if (!config.disableMeshRenderer)
 		MeshRenderer::init();
 	if (!config.disableShape2D)
-		Shape2D::init();
+		Shape2D::init(config.headless);
 	if (!config.disableGLText)
-		GLText::init(config.fontPath.c_str());
+		GLText::init(config.fontPath.c_str(), config.headless);
 	if (!config.disablePictureDraw)
 		PictureDraw::init();
 }
@@ -38,6 +44,14 @@ void RenderHelpers::unload() {
 }
 
 void RenderHelpers::flushAll() {
+	if (config_.headless) {
+		// there's no GL context to check for errors; this just discards the pending geometry
+		if (!config_.disableShape2D)
+			Shape2D::get()->flush();
+		if (!config_.disableGLText)
+			GLText::get()->flush();
+		return;
+	}
 	checkGLError("before RenderHelpers::flushAll()");
 	if (!config_.disableShape2D)
 		Shape2D::get()->flush();
@@ -15,6 +15,7 @@
 #include <boglfw/utils/log.h>
 #include <boglfw/utils/arrayContainer.h>
 #include <boglfw/perf/marker.h>
+#include <boglfw/perf/counters.h>
 
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -25,8 +26,8 @@
 
 static Shape2D* instance = nullptr;
 
-void Shape2D::init() {
-	instance = new Shape2D();
+void Shape2D::init(bool headless) {
+	instance = new Shape2D(headless);
 }
 
 Shape2D* Shape2D::get() {
@@ -34,7 +35,10 @@ Shape2D* Shape2D::get() {
 	return instance;
 }
 
-Shape2D::Shape2D() {
+Shape2D::Shape2D(bool headless)
+	: headless_(headless) {
+	if (headless)
+		return;
 	LOGPREFIX("Shape2D");
 	glGenVertexArrays(1, &lineVAO_);
 	glGenBuffers(1, &lineVBO_);
@@ -77,6 +81,8 @@ Shape2D::Shape2D() {
 }
 
 Shape2D::~Shape2D() {
+	if (headless_)
+		return;
 	glDeleteProgram(shaderProgram_);
 	glDeleteVertexArrays(1, &triangleVAO_);
 	glDeleteVertexArrays(1, &lineVAO_);
@@ -92,6 +98,10 @@ void Shape2D::unload() {
 
 void Shape2D::flush() {
 	PERF_MARKER_FUNC;
+	if (headless_) {
+		purgeBuffers();
+		return;
+	}
 
 	// populate device buffers
 	glBindBuffer(GL_ARRAY_BUFFER, lineVBO_);
@@ -103,6 +113,8 @@ void Shape2D::flush() {
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, triangleIBO_);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(triangleIndices_[0]) * triangleIndices_.size(), &triangleIndices_[0], GL_DYNAMIC_DRAW);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	PERF_COUNTER("bytes-uploaded", sizeof(s_lineVertex) * (lineBuffer_.size() + triangleBuffer_.size())
+		+ sizeof(lineIndices_[0]) * lineIndices_.size() + sizeof(triangleIndices_[0]) * triangleIndices_.size());
 
 	glUseProgram(shaderProgram_);
 	glEnable(GL_BLEND);
@@ -127,6 +139,7 @@ void Shape2D::flush() {
 		glBindVertexArray(triangleVAO_);
 		glDrawElements(GL_TRIANGLES, nTriIndices, GL_UNSIGNED_SHORT, 0);
 		checkGLError("Shape2D::render() : glDrawElements #1");
+		PERF_COUNTER("draw-calls", 1);
 	}
 
 	// render line primitives
@@ -135,13 +148,17 @@ void Shape2D::flush() {
 		glDrawElements(GL_LINES, lineStrips_[l].length, GL_UNSIGNED_SHORT, (void*)(sizeof(lineIndices_[0]) * lineStrips_[l].offset));
 		checkGLError("Shape2D::render() : glDrawElements #2");
 	}
+	PERF_COUNTER("draw-calls", lineStrips_.size());
 
 	glBindVertexArray(0);
 	glUseProgram(0);
 	glDisable(GL_BLEND);
 	glEnable(GL_DEPTH_TEST);
 
-	// purge cached data
+	purgeBuffers();
+}
+
+void Shape2D::purgeBuffers() {
 	lineBuffer_.clear();
 	lineIndices_.clear();
 	triangleBuffer_.clear();
@@ -13,6 +13,7 @@
 #include <boglfw/renderOpenGL/glToolkit.h>
 #include <boglfw/math/math3D.h>
 #include <boglfw/utils/log.h>
+#include <boglfw/perf/counters.h>
 
 #include <glm/vec4.hpp>
 #include <glm/gtx/rotate_vector.hpp>
@@ -95,6 +96,7 @@ void Shape3D::flush() {
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO_);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices_[0]) * indices_.size(), &indices_[0], GL_DYNAMIC_DRAW);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	PERF_COUNTER("bytes-uploaded", sizeof(s_vertex) * buffer_.size() + sizeof(indices_[0]) * indices_.size());
 
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -108,6 +110,7 @@ void Shape3D::flush() {
 
 	glDrawElements(GL_LINES, nIndices, GL_UNSIGNED_INT, 0);
 	checkGLError("Shape3D::glDrawElements");
+	PERF_COUNTER("draw-calls", 1);
 
 	glDisable(GL_BLEND);
 	glBindVertexArray(0);
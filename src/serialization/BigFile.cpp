@@ -7,32 +7,18 @@
 
 #include <boglfw/serialization/BigFile.h>
 #include <boglfw/serialization/BinaryStream.h>
+#include <boglfw/serialization/BigFile_header.h>
 #include <boglfw/serialization/BigFile_v1.h>
+#include <boglfw/serialization/BigFile_v2.h>
+#include <boglfw/serialization/BigFileWriter.h>
 #include <boglfw/utils/log.h>
+#include <boglfw/utils/parallel.h>
 
 #include <memory.h>
 #include <stdint.h>
 #include <fstream>
-
-static constexpr uint32_t BIGFILE_MAGIC = 0xB16F17E5;
-
-struct bigFile_header {
-	uint32_t magic = BIGFILE_MAGIC;
-	uint32_t version;
-	uint32_t reserved[8]; // for future extension
-};
-BinaryStream& operator << (BinaryStream& stream, bigFile_header const& h) {
-	stream << h.magic << h.version;
-	for (int i=0; i<8; i++)
-		stream << h.reserved[i];
-	return stream;
-}
-BinaryStream& operator >> (BinaryStream& stream, bigFile_header &h) {
-	stream >> h.magic >> h.version;
-	for (int i=0; i<8; i++)
-		stream >> h.reserved[i];
-	return stream;
-}
+#include <algorithm>
+#include <atomic>
 
 bool BigFile::loadFromDisk_v1(BinaryStream &fileStream) {
 	bigFile_tableHeader_v1 tableHeader;
@@ -43,38 +29,56 @@ bool BigFile::loadFromDisk_v1(BinaryStream &fileStream) {
 		fileStream >> entry;
 		tableEntries.push_back(entry);
 	}
+	if (mapping_.isOpen()) {
+		// the entries point straight into the mapping
+		const char* contents = mapping_.data() + fileStream.getPos();
+		size_t contentsSize = mapping_.size() - fileStream.getPos();
+		for (unsigned i=0; i<tableHeader.numEntries; i++) {
+			if ((size_t)tableEntries[i].offset + tableEntries[i].size > contentsSize) {
+				ERROR("Corrupted BigFile: entry \"" << tableEntries[i].filename << "\" is past the end of the file");
+				return false;
+			}
+			FileDescriptor &fd = mapFiles[tableEntries[i].filename];
+			fd.fileName = tableEntries[i].filename;
+			fd.size = tableEntries[i].size;
+			fd.ownsMemory_ = false;
+			fd.pStart = const_cast<char*>(contents + tableEntries[i].offset);
+		}
+		return true;
+	}
 	for (unsigned i=0; i<tableHeader.numEntries; i++) {
 		FileDescriptor &fd = mapFiles[tableEntries[i].filename];
 		fd.fileName = tableEntries[i].filename;
 		fd.size = tableEntries[i].size;
 		fd.ownsMemory_ = true;
 		fd.pStart = malloc(fd.size);
-		#warning "may defer actual malloc and read until the file is requested"
 		fileStream.read(fd.pStart, fd.size);
 	}
 	return true;
 }
 
-bool BigFile::saveToDisk_v1(const std::string &path) {
-	LOGPREFIX("BigFile")
+bool BigFile::saveToDisk_v1(const std::string &path, std::vector<FileDescriptor> const& files) {
 	// 1. build header
 	bigFile_header hdr;
 	hdr.version = 1;
 
 	// 2. build file table
 	bigFile_tableHeader_v1 tableHeader;
-	tableHeader.numEntries = mapFiles.size();
-	BinaryStream tableStream(mapFiles.size() * sizeof(bigFile_tableEntry_v1) * 2);
-	unsigned offset = 0;
-	for (std::pair<const std::string, FileDescriptor> &pair : mapFiles) {
-		FileDescriptor &fd = pair.second;
+	tableHeader.numEntries = files.size();
+	BinaryStream tableStream(files.size() * sizeof(bigFile_tableEntry_v1) * 2);
+	uint64_t offset = 0;
+	for (auto &fd : files) {
 		bigFile_tableEntry_v1 entry;
-		entry.filename = pair.first;
+		entry.filename = fd.fileName;
 		entry.offset = offset;
 		entry.size = fd.size;
 		tableStream << entry;
 		offset += fd.size;
 	}
+	if (offset > UINT32_MAX) {
+		ERROR("Contents too large for version 1 (" << offset << " bytes), save as version 2 instead");
+		return false;
+	}
 	// update table header tableSize field:
 	tableHeader.tableSize = tableStream.size();
 
@@ -87,11 +91,13 @@ bool BigFile::saveToDisk_v1(const std::string &path) {
 		std::ofstream file(path, std::ios::out | std::ios::binary);
 		file.write((const char*)headerAndTableStream.getBuffer(), headerAndTableStream.size());
 		file.write((const char*)tableStream.getBuffer(), tableStream.size());
-		for (auto &pair : mapFiles) {
-			FileDescriptor &fd = pair.second;
+		for (auto &fd : files)
 			file.write((const char*)fd.pStart, fd.size);
-		}
 		file.close();
+		if (file.fail()) {
+			ERROR("Could not write " << path);
+			return false;
+		}
 	} catch (std::ios::failure &e) {
 		ERROR(e.what());
 		return false;
@@ -99,42 +105,315 @@ bool BigFile::saveToDisk_v1(const std::string &path) {
 	return true;
 }
 
-bool BigFile::loadFromDisk(const std::string &path) {
-	LOGPREFIX("BigFile")
-	try {
-		std::ifstream file(path, std::ios::in | std::ios::binary);
-		// void* hdrBinData = malloc(sizeof(bigFile_header));
-		// file.read((char*)hdrBinData, sizeof(bigFile_header));
-		//BinaryStream hdrStream(hdrBinData, sizeof(bigFile_header));
-		BinaryStream fileStream(file);
-		bigFile_header hdr;
-		fileStream >> hdr;
-		if (hdr.magic != BIGFILE_MAGIC) {
-			LOGLN("WARNING: Invalid or corrupted BigFile (wrong magic!) at: "<<path);
+static bool isPow2(uint64_t x) {
+	return x && !(x & (x - 1));
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static constexpr bool tableUsableInPlace = false;	// the table is little endian
+#else
+static constexpr bool tableUsableInPlace = true;
+#endif
+
+// the body of a compressed entry, waiting to be decompressed into its FileDescriptor
+struct bigFile_compressedBody {
+	CompressionMethod method;
+	const char* data;
+	uint64_t storedSize;
+	BigFile::FileDescriptor* fd;	// the destination, already allocated
+};
+
+static bool decompressBodies(std::vector<bigFile_compressedBody> &bodies, ThreadPool* pool) {
+	std::atomic<bool> failed { false };
+	auto decompress = [&failed] (bigFile_compressedBody &body) {
+		if (!Compression::decompress(body.method, body.data, body.storedSize, body.fd->pStart, body.fd->size))
+			failed.store(true, std::memory_order_relaxed);
+	};
+	if (pool && bodies.size() > 1)
+		parallel_for(bodies.begin(), bodies.end(), *pool, decompress);
+	else
+		for (auto &body : bodies)
+			decompress(body);
+	if (failed) {
+		ERROR("Corrupted BigFile: an entry could not be decompressed");
+		return false;
+	}
+	return true;
+}
+
+bool BigFile::loadFromDisk_v2(BinaryStream &fileStream, const std::string &path, ThreadPool* pool) {
+	// the table comes after the bodies and BinaryStreams can't seek back, so the file is always read through a mapping;
+	// in ReadAll mode it's a temporary one that the entries are copied out of
+	MappedFile tempMapping;
+	const bool readAll = !mapping_.isOpen();
+	if (readAll) {
+		if (!tempMapping.open(path))
+			return false;
+		tempMapping.adviseSequential();
+	}
+	MappedFile const& mapping = readAll ? tempMapping : mapping_;
+	const uint64_t fileSize = mapping.size();
+	bigFile_tableHeader_v2 th;
+	fileStream >> th;
+	// a valid writer leaves at least one bucket empty (checked below, when the index is used)
+	if (!isPow2(th.numBuckets) || th.numBuckets <= th.numEntries || !isPow2(th.alignment)
+		|| th.entriesOffset % 8 || th.entriesOffset > fileSize
+		|| (uint64_t)th.numEntries * sizeof(bigFile_tableEntry_v2) > fileSize - th.entriesOffset
+		|| th.bucketsOffset % 4 || th.bucketsOffset > fileSize
+		|| (uint64_t)th.numBuckets * sizeof(uint32_t) > fileSize - th.bucketsOffset
+		|| th.namesOffset > fileSize || th.namesSize > fileSize - th.namesOffset) {
+		ERROR("Corrupted BigFile: invalid table header");
+		return false;
+	}
+	std::vector<bigFile_tableEntry_v2> entryCopies;
+	const bigFile_tableEntry_v2* entries;
+	if (tableUsableInPlace)
+		entries = reinterpret_cast<const bigFile_tableEntry_v2*>(mapping.data() + th.entriesOffset);
+	else {
+		BinaryStream entriesStream(const_cast<char*>(mapping.data() + th.entriesOffset),
+				th.numEntries * sizeof(bigFile_tableEntry_v2));
+		entryCopies.resize(th.numEntries);
+		for (auto &e : entryCopies)
+			entriesStream >> e;
+		entries = entryCopies.data();
+	}
+	unsigned numCompressed = 0;
+	for (uint32_t i=0; i<th.numEntries; i++) {
+		auto &e = entries[i];
+		if (e.offset > fileSize || e.storedSize > fileSize - e.offset
+			|| (uint64_t)e.nameOffset + e.nameLength >= th.namesSize) {
+			ERROR("Corrupted BigFile: invalid entry #" << i);
 			return false;
 		}
-		switch (hdr.version) {
-		case 1:
-			return loadFromDisk_v1(fileStream);
-		default:
-			LOGLN("WARNING: No known method to handle version "<<hdr.version<<" of BigFile! canceling...");
+		auto method = (CompressionMethod)(e.flags & bigFile_entryCompressionMask);
+		if ((e.flags & ~bigFile_entryCompressionMask) || !Compression::isAvailable(method)) {
+			ERROR("Unsupported BigFile entry #" << i << " (flags " << e.flags << ", compression "
+				<< Compression::getName(method) << ")");
 			return false;
 		}
+		if (method == CompressionMethod::None && e.storedSize != e.size) {
+			ERROR("Corrupted BigFile: invalid entry #" << i);
+			return false;
+		}
+		if (method != CompressionMethod::None)
+			numCompressed++;
+	}
+	const char* names = mapping.data() + th.namesOffset;
+	// compressed entries can't be used in place; they're decompressed into mapFiles
+	std::vector<bigFile_compressedBody> compressedBodies;
+	compressedBodies.reserve(numCompressed);
+	auto addCompressed = [&] (bigFile_tableEntry_v2 const& e) -> bool {
+		std::string name(names + e.nameOffset, e.nameLength);
+		FileDescriptor &fd = mapFiles[name];
+		fd.fileName = name;
+		fd.size = e.size;
+		fd.ownsMemory_ = true;
+		fd.pStart = malloc(fd.size);
+		if (!fd.pStart && fd.size) {
+			ERROR("Out of memory for entry \"" << name << "\" (" << fd.size << " bytes)");
+			return false;
+		}
+		compressedBodies.push_back(bigFile_compressedBody {
+			(CompressionMethod)(e.flags & bigFile_entryCompressionMask), mapping.data() + e.offset, e.storedSize, &fd
+		});
+		return true;
+	};
+	if (!readAll && tableUsableInPlace) {
+		auto buckets = reinterpret_cast<const uint32_t*>(mapping.data() + th.bucketsOffset);
+		uint32_t emptyBuckets = 0;
+		for (uint32_t b=0; b<th.numBuckets; b++) {
+			if (buckets[b] > th.numEntries) {
+				ERROR("Corrupted BigFile: invalid hash index");
+				return false;
+			}
+			emptyBuckets += buckets[b] == 0;
+		}
+		// looking up a missing name stops at the first empty bucket, so without any it would never end
+		if (!emptyBuckets) {
+			ERROR("Corrupted BigFile: full hash index");
+			return false;
+		}
+		mappedEntries_ = entries;
+		mappedBuckets_ = buckets;
+		mappedNames_ = names;
+		mappedCount_ = th.numEntries;
+		mappedBucketMask_ = th.numBuckets - 1;
+		for (uint32_t i=0; numCompressed && i<th.numEntries; i++)
+			if (entries[i].flags && !addCompressed(entries[i]))
+				return false;
+		return decompressBodies(compressedBodies, pool);
+	}
+
+	// the index isn't needed for building mapFiles
+	for (uint32_t i=0; i<th.numEntries; i++) {
+		auto &e = entries[i];
+		if (e.flags) {
+			if (!addCompressed(e))
+				return false;
+			continue;
+		}
+		std::string name(names + e.nameOffset, e.nameLength);
+		FileDescriptor &fd = mapFiles[name];
+		fd.fileName = name;
+		fd.size = e.size;
+		if (readAll) {
+			fd.ownsMemory_ = true;
+			fd.pStart = malloc(fd.size);
+			memcpy(fd.pStart, mapping.data() + e.offset, fd.size);
+		} else {
+			fd.ownsMemory_ = false;
+			fd.pStart = const_cast<char*>(mapping.data() + e.offset);
+		}
+	}
+	return decompressBodies(compressedBodies, pool);
+}
+
+bool BigFile::saveToDisk_v2(const std::string &path, std::vector<FileDescriptor> const& files, BigFileSaveOptions const& options) {
+	BigFileWriter writer;
+	if (!writer.open(path, options))
+		return false;
+	if (!options.threadPool || options.compression == CompressionMethod::None) {
+		for (auto &fd : files)
+			if (!writer.addFile(fd.fileName, fd.pStart, fd.size))
+				return false;
+		return writer.finish();
+	}
+	// compress in batches on the pool, so that only one batch of compressed bodies is held in memory
+	const size_t batchSize = options.threadPool->getThreadCount() * 4;
+	std::vector<std::vector<char>> compressed(std::min(batchSize, files.size()));
+	std::vector<unsigned> indexes;
+	for (size_t first = 0; first < files.size(); first += batchSize) {
+		size_t count = std::min(batchSize, files.size() - first);
+		indexes.resize(count);
+		for (unsigned i=0; i<count; i++)
+			indexes[i] = i;
+		parallel_for(indexes.begin(), indexes.end(), *options.threadPool, [&] (unsigned i) {
+			auto &fd = files[first + i];
+			// only keep the compressed body if it's smaller
+			compressed[i].resize(fd.size > 1 ? fd.size - 1 : 0);
+			compressed[i].resize(fd.size > 1
+				? Compression::compress(options.compression, fd.pStart, fd.size, compressed[i].data(), compressed[i].size(),
+					options.compressionLevel)
+				: 0);
+		});
+		for (unsigned i=0; i<count; i++) {
+			auto &fd = files[first + i];
+			bool added = compressed[i].empty()
+				? writer.addStored(fd.fileName, fd.size, fd.pStart, fd.size, CompressionMethod::None)
+				: writer.addStored(fd.fileName, fd.size, compressed[i].data(), compressed[i].size(), options.compression);
+			if (!added)
+				return false;
+		}
+	}
+	return writer.finish();
+}
+
+bool BigFile::load(BinaryStream &fileStream, const std::string &path, ThreadPool* pool) {
+	bigFile_header hdr;
+	fileStream >> hdr;
+	if (hdr.magic != BIGFILE_MAGIC) {
+		LOGLN("WARNING: Invalid or corrupted BigFile (wrong magic!) at: "<<path);
+		return false;
+	}
+	switch (hdr.version) {
+	case 1:
+		return loadFromDisk_v1(fileStream);
+	case 2:
+		return loadFromDisk_v2(fileStream, path, pool);
+	default:
+		LOGLN("WARNING: No known method to handle version "<<hdr.version<<" of BigFile! canceling...");
+		return false;
+	}
+}
+
+bool BigFile::loadFromDisk(const std::string &path, LoadMode mode, ThreadPool* pool) {
+	LOGPREFIX("BigFile")
+	// the entries of a previous mapped load point into the old mapping
+	unmap();
+	try {
+		if (mode == LoadMode::Mapped) {
+			if (!mapping_.open(path))
+				return false;
+			BinaryStream fileStream(const_cast<char*>(mapping_.data()), mapping_.size());
+			if (load(fileStream, path, pool))
+				return true;
+			unmap();
+			return false;
+		}
+		std::ifstream file(path, std::ios::in | std::ios::binary);
+		BinaryStream fileStream(file);
+		return load(fileStream, path, pool);
 	} catch (std::ios::failure &e) {
 		ERROR("EXCEPTION during loading from disk (" << path<<"):\n" << e.what());
-		return false;
 	} catch (std::runtime_error &e) {
 		ERROR("EXCEPTION during deserialization from file "<< path<<":\n" << e.what());
-		return false;
 	}
-	assertDbg(!!!"should never reach this");
+	unmap();
 	return false;
 }
 
-bool BigFile::saveToDisk(const std::string &path) {
+void BigFile::unmap() {
+	if (!mapping_.isOpen())
+		return;
+	mapFiles.clear();
+	mappedEntries_ = nullptr;
+	mappedBuckets_ = nullptr;
+	mappedNames_ = nullptr;
+	mappedCount_ = mappedBucketMask_ = 0;
+	mapping_.close();
+}
+
+void BigFile::prefetch(const std::string &name) const {
+	if (!mapping_.isOpen())
+		return;
+	// entries in mapFiles are either views into the mapping or already in memory
+	auto it = mapFiles.find(name);
+	if (it != mapFiles.end()) {
+		if (!it->second.ownsMemory_)
+			mapping_.prefetch((const char*)it->second.pStart - mapping_.data(), it->second.size);
+	} else if (auto e = findMapped(name))
+		mapping_.prefetch(e->offset, e->storedSize);
+}
+
+void BigFile::prefetchAll() const {
+	if (mapping_.isOpen()) {
+		mapping_.adviseSequential();
+		mapping_.prefetch(0, mapping_.size());
+	}
+}
+
+bool BigFile::saveToDisk(const std::string &path, BigFileSaveOptions const& options) {
 	LOGPREFIX("BigFile")
-	saveToDisk_v1(path);
-	return true;
+	auto files = getAllFiles();
+	switch (options.formatVersion) {
+	case 1:
+		if (options.compression != CompressionMethod::None) {
+			ERROR("Version 1 doesn't support compression");
+			return false;
+		}
+		return saveToDisk_v1(path, files);
+	case 2:
+		return saveToDisk_v2(path, files, options);
+	default:
+		ERROR("Unknown BigFile version " << options.formatVersion);
+		return false;
+	}
+}
+
+const bigFile_tableEntry_v2* BigFile::findMapped(const std::string &name) const {
+	if (!mappedEntries_)
+		return nullptr;
+	uint64_t hash = bigFile_nameHash(name.data(), name.size());
+	for (uint32_t b = hash & mappedBucketMask_; mappedBuckets_[b]; b = (b + 1) & mappedBucketMask_) {
+		auto &e = mappedEntries_[mappedBuckets_[b] - 1];
+		if (e.nameHash == hash && e.nameLength == name.size() && !memcmp(mappedNames_ + e.nameOffset, name.data(), name.size()))
+			return &e;
+	}
+	return nullptr;
+}
+
+BigFile::FileDescriptor BigFile::getMappedFile(bigFile_tableEntry_v2 const& e) const {
+	return FileDescriptor(e.size, const_cast<char*>(mapping_.data() + e.offset), std::string(mappedNames_ + e.nameOffset, e.nameLength));
 }
 
 const BigFile::FileDescriptor BigFile::getFile(const std::string &name) const {
@@ -142,16 +421,27 @@ const BigFile::FileDescriptor BigFile::getFile(const std::string &name) const {
 	auto it = mapFiles.find(name);
 	if (it != mapFiles.end())
 		return it->second;
-	else {
-		LOGLN("WARNING: file \""<<name<<"\" doesn't exist in BigFile!!");
-		return FileDescriptor();
-	}
+	if (auto e = findMapped(name))
+		return getMappedFile(*e);
+	LOGLN("WARNING: file \""<<name<<"\" doesn't exist in BigFile!!");
+	return FileDescriptor();
 }
 
 const std::vector<BigFile::FileDescriptor> BigFile::getAllFiles() const {
 	std::vector<FileDescriptor> vec;
 	for (auto &pair : mapFiles)
 		vec.push_back(pair.second);
+	if (mappedCount_) {
+		// entries added after loading take the place of the mapped ones with the same name
+		for (uint32_t i=0; i<mappedCount_; i++) {
+			auto fd = getMappedFile(mappedEntries_[i]);
+			if (!mapFiles.count(fd.fileName))
+				vec.push_back(fd);
+		}
+		std::sort(vec.begin(), vec.end(), [] (FileDescriptor const& a, FileDescriptor const& b) {
+			return a.fileName < b.fileName;
+		});
+	}
 	return vec;
 }
 
@@ -0,0 +1,288 @@
+/*
+ * BigFileWriter.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifdef __WIN32__
+// wingdi.h would define ERROR, which clashes with our logging macro
+#define NOGDI
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <boglfw/serialization/BigFileWriter.h>
+#include <boglfw/serialization/BigFile_header.h>
+#include <boglfw/serialization/BinaryStream.h>
+#include <boglfw/utils/filesystem.h>
+#include <boglfw/utils/log.h>
+
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+static constexpr uint64_t tableHeaderOffset = sizeof(uint32_t) * 10;	// right after the bigFile_header
+static constexpr uint64_t bodiesOffset = tableHeaderOffset + sizeof(bigFile_tableHeader_v2);
+
+static uint64_t alignUp(uint64_t x, uint64_t alignment) {
+	return (x + alignment - 1) & ~(alignment - 1);
+}
+
+static bool isPow2(uint64_t x) {
+	return x && !(x & (x - 1));
+}
+
+static bool syncToDisk(FILE* file) {
+	if (fflush(file))
+		return false;
+#ifdef __WIN32__
+	return _commit(_fileno(file)) == 0;
+#else
+	return fsync(fileno(file)) == 0;
+#endif
+}
+
+// atomically replaces the destination with the source; readers that still have the old file open or mapped keep
+// seeing the old contents (on Windows this fails while the destination is mapped)
+static bool replaceFile(std::string const& source, std::string const& dest) {
+#ifdef __WIN32__
+	return MoveFileExA(source.c_str(), dest.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	return rename(source.c_str(), dest.c_str()) == 0;
+#endif
+}
+
+// makes a rename in the file's directory durable
+static bool syncDirectory(std::string const& filePath) {
+#ifdef __WIN32__
+	return true;	// MOVEFILE_WRITE_THROUGH already did
+#else
+	std::string dir = filesystem::getFileDirectory(filePath);
+	int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	bool synced = fsync(fd) == 0;
+	::close(fd);
+	return synced;
+#endif
+}
+
+BigFileWriter::~BigFileWriter() {
+	LOGPREFIX("BigFileWriter")
+	if (isOpen()) {
+		LOGLN("WARNING: \"" << path_ << "\" was not finished, discarding it");
+		abort();
+	}
+}
+
+bool BigFileWriter::open(std::string const& path, BigFileSaveOptions const& options) {
+	LOGPREFIX("BigFileWriter")
+	if (isOpen())
+		abort();
+	if (options.formatVersion != 2) {
+		ERROR("Only version 2 files can be written in one pass");
+		return false;
+	}
+	if (!isPow2(options.alignment)) {
+		ERROR("Invalid alignment " << options.alignment << " (must be a power of two)");
+		return false;
+	}
+	if (!Compression::isAvailable(options.compression)) {
+		ERROR("Compression method " << Compression::getName(options.compression) << " is not available in this build");
+		return false;
+	}
+	// the destination is only replaced by finish(), so an interrupted save leaves the previous file intact
+	tempPath_ = path + ".tmp";
+	file_ = fopen(tempPath_.c_str(), "wb");
+	if (!file_) {
+		ERROR(errno << ": Could not create \"" << tempPath_ << "\"");
+		return false;
+	}
+	path_ = path;
+	options_ = options;
+	offset_ = 0;
+	entries_.clear();
+	names_.clear();
+	nameIndex_.clear();
+	// the table header stays zeroed (and the file invalid) until finish()
+	bigFile_header hdr;
+	hdr.version = 2;
+	bigFile_tableHeader_v2 tableHeader {};
+	BinaryStream headerStream(bodiesOffset);
+	headerStream << hdr << tableHeader;
+	assertDbg(headerStream.size() == bodiesOffset);
+	return write(headerStream.getBuffer(), headerStream.size()) || fail();
+}
+
+bool BigFileWriter::addFile(std::string const& name, const void* buffer, size_t size) {
+	if (options_.compression != CompressionMethod::None && size >= 2) {
+		// only keep the compressed body if it's smaller
+		compressBuffer_.resize(std::max(compressBuffer_.size(), size - 1));
+		size_t compressedSize = Compression::compress(options_.compression, buffer, size,
+				compressBuffer_.data(), size - 1, options_.compressionLevel);
+		if (compressedSize)
+			return addStored(name, size, compressBuffer_.data(), compressedSize, options_.compression);
+	}
+	return addStored(name, size, buffer, size, CompressionMethod::None);
+}
+
+bool BigFileWriter::addStored(std::string const& name, uint64_t size, const void* body, uint64_t storedSize,
+		CompressionMethod method) {
+	LOGPREFIX("BigFileWriter")
+	if (!isOpen()) {
+		ERROR("Can't add \"" << name << "\": the writer is not open");
+		return false;
+	}
+	uint64_t hash = bigFile_nameHash(name.data(), name.size());
+	auto range = nameIndex_.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it) {
+		auto &e = entries_[it->second];
+		if (e.nameLength == name.size() && !names_.compare(e.nameOffset, e.nameLength, name)) {
+			ERROR("Duplicate entry \"" << name << "\" in " << path_);
+			return fail(false);
+		}
+	}
+	if (entries_.size() >= UINT32_MAX - 1 || names_.size() + name.size() >= UINT32_MAX) {
+		ERROR("Too many entries in " << path_);
+		return fail(false);
+	}
+	if (!writePadding(options_.alignment))
+		return fail();
+	bigFile_tableEntry_v2 e {};
+	e.offset = offset_;
+	e.size = size;
+	e.storedSize = storedSize;
+	e.nameHash = hash;
+	e.nameOffset = names_.size();
+	e.nameLength = name.size();
+	e.flags = (uint32_t)method;
+	if (!write(body, storedSize))
+		return fail();
+	nameIndex_.emplace(hash, entries_.size());
+	entries_.push_back(e);
+	names_.append(name.c_str(), name.size() + 1);
+	return true;
+}
+
+bool BigFileWriter::finish() {
+	LOGPREFIX("BigFileWriter")
+	if (!isOpen()) {
+		ERROR("finish() called on a writer that is not open");
+		return false;
+	}
+	bigFile_header hdr;
+	hdr.version = 2;
+	bigFile_tableHeader_v2 tableHeader {};
+	tableHeader.numEntries = entries_.size();
+	tableHeader.numBuckets = 1;
+	while (tableHeader.numBuckets <= 2 * entries_.size())
+		tableHeader.numBuckets <<= 1;	// less than half full
+	tableHeader.alignment = options_.alignment;
+	if (!writePadding(8))
+		return fail();
+	tableHeader.entriesOffset = offset_;
+	tableHeader.bucketsOffset = tableHeader.entriesOffset + entries_.size() * sizeof(bigFile_tableEntry_v2);
+	tableHeader.namesOffset = tableHeader.bucketsOffset + tableHeader.numBuckets * sizeof(uint32_t);
+	tableHeader.namesSize = names_.size();
+
+	// the table is serialized in chunks, so that it doesn't need another copy of itself in memory
+	static constexpr unsigned chunkSize = 1024;
+	BinaryStream stream(chunkSize * sizeof(bigFile_tableEntry_v2));
+	for (unsigned i=0; i<entries_.size(); i++) {
+		stream << entries_[i];
+		if ((i + 1) % chunkSize == 0 || i + 1 == entries_.size()) {
+			if (!write(stream.getBuffer(), stream.size()))
+				return fail();
+			stream.clear();
+		}
+	}
+	std::vector<uint32_t> buckets(tableHeader.numBuckets, 0);
+	const uint32_t mask = tableHeader.numBuckets - 1;
+	for (unsigned i=0; i<entries_.size(); i++) {
+		uint32_t b = entries_[i].nameHash & mask;
+		while (buckets[b])
+			b = (b + 1) & mask;
+		buckets[b] = i + 1;
+	}
+	for (unsigned i=0; i<buckets.size(); i++) {
+		stream << buckets[i];
+		if ((i + 1) % chunkSize == 0 || i + 1 == buckets.size()) {
+			if (!write(stream.getBuffer(), stream.size()))
+				return fail();
+			stream.clear();
+		}
+	}
+	if (!write(names_.data(), names_.size()))
+		return fail();
+	assertDbg(offset_ == tableHeader.namesOffset + tableHeader.namesSize);
+
+	// everything else must be on the disk before the table header makes the file valid
+	if (options_.fsync && !syncToDisk(file_))
+		return fail();
+	stream.clear();
+	stream << hdr << tableHeader;
+	if (fseek(file_, 0, SEEK_SET) || fwrite(stream.getBuffer(), stream.size(), 1, file_) != 1)
+		return fail();
+	if (options_.fsync ? !syncToDisk(file_) : fflush(file_) != 0)
+		return fail();
+	bool closed = fclose(file_) == 0;
+	file_ = nullptr;
+	entries_ = decltype(entries_)();
+	names_ = decltype(names_)();
+	nameIndex_.clear();
+	if (!closed) {
+		ERROR(errno << ": Could not write " << tempPath_);
+		remove(tempPath_.c_str());
+		return false;
+	}
+	if (!replaceFile(tempPath_, path_)) {
+		ERROR(errno << ": Could not replace \"" << path_ << "\" with \"" << tempPath_ << "\"");
+		remove(tempPath_.c_str());
+		return false;
+	}
+	if (options_.fsync && !syncDirectory(path_)) {
+		// the new file is complete, only its name may not survive a crash yet
+		LOGLN("WARNING: could not sync the directory of " << path_);
+	}
+	return true;
+}
+
+void BigFileWriter::abort() {
+	if (!isOpen())
+		return;
+	fclose(file_);
+	file_ = nullptr;
+	remove(tempPath_.c_str());
+	entries_ = decltype(entries_)();
+	names_ = decltype(names_)();
+	nameIndex_.clear();
+}
+
+bool BigFileWriter::write(const void* data, size_t size) {
+	if (size && fwrite(data, size, 1, file_) != 1)
+		return false;
+	offset_ += size;
+	return true;
+}
+
+bool BigFileWriter::writePadding(uint64_t alignment) {
+	static const char zeros[4096] {};
+	uint64_t target = alignUp(offset_, alignment);
+	while (offset_ < target)
+		if (!write(zeros, std::min<uint64_t>(sizeof(zeros), target - offset_)))
+			return false;
+	return true;
+}
+
+// closes and removes the file; always returns false
+bool BigFileWriter::fail(bool logWriteError) {
+	LOGPREFIX("BigFileWriter")
+	if (logWriteError)
+		ERROR(errno << ": Could not write " << tempPath_);
+	abort();
+	return false;
+}
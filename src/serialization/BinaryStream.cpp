@@ -41,6 +41,11 @@ void BinaryStream::seek(size_t offset) {
 	pos_ = offset;
 }
 
+void BinaryStream::clear() {
+	assertDbg(!ifstream_);
+	pos_ = size_ = 0;
+}
+
 void BinaryStream::expandBuffer() {
 	assertDbg(ownsBuffer_);
 	void* newBuf = malloc(capacity_*=2);
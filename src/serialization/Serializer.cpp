@@ -7,10 +7,10 @@
 
 #include <boglfw/serialization/Serializer.h>
 #include <boglfw/serialization/BigFile.h>
+#include <boglfw/serialization/BigFileWriter.h>
 #include <boglfw/serialization/BinaryStream.h>
 #include <boglfw/utils/log.h>
 
-#include <memory>
 #include <sstream>
 
 std::map<int, Serializer::DeserializeFuncType> Serializer::mapTypesToFuncs_;
@@ -49,9 +49,14 @@ std::string Serializer::getObjectTypeString(int type) {
 
 bool Serializer::serializeToFile(const std::string &path) {
 	LOGPREFIX("Serializer");
+	// each object goes to the disk as soon as it's serialized, so only one of them is in memory at a time
+	BigFileWriter writer;
+	if (!writer.open(path)) {
+		serializationQueue_.clear();
+		return false;
+	}
 	BinaryStream masterStream(serializationQueue_.size() * 50); // estimate about 50 bytes per entry in master
-	std::vector<std::unique_ptr<BinaryStream>> vecStreams;
-	std::vector<std::string> vecFilenames;
+	BinaryStream objectStream(4096);
 	int fileIndex = 1;
 	for (auto &e : serializationQueue_) {
 		int objType = e.getType();
@@ -59,22 +64,18 @@ bool Serializer::serializeToFile(const std::string &path) {
 		masterStream << objType;
 		std::stringstream pathBuild;
 		pathBuild << getObjectTypeString(e.getType()) << fileIndex << ".data";
-		vecFilenames.push_back(pathBuild.str());
 		masterStream << pathBuild.str();
-		std::unique_ptr<BinaryStream> fileStream(new BinaryStream(100));
-		e.serialize(*fileStream);
-		vecStreams.push_back(std::move(fileStream));
+		objectStream.clear();
+		e.serialize(objectStream);
+		if (!writer.addFile(pathBuild.str(), objectStream.getBuffer(), objectStream.size())) {
+			serializationQueue_.clear();
+			return false;
+		}
 
 		fileIndex++;
 	}
 	serializationQueue_.clear();
-	BigFile bigFile;
-	bigFile.addFile("master", masterStream.getBuffer(), masterStream.size());
-	for (unsigned i=0; i<vecStreams.size(); i++) {
-		bigFile.addFile(vecFilenames[i], vecStreams[i]->getBuffer(), vecStreams[i]->size());
-		vecStreams[i].reset();
-	}
-	return bigFile.saveToDisk(path);
+	return writer.addFile("master", masterStream.getBuffer(), masterStream.size()) && writer.finish();
 }
 
 bool Serializer::deserializeFromFile(const std::string &path) {
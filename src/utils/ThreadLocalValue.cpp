@@ -7,6 +7,53 @@
 
 #include <boglfw/utils/ThreadLocalValue.h>
 
+#include <mutex>
+#include <atomic>
+
 namespace ThreadLocalValuePrivate {
-	thread_local std::map<void*, vtype> mapThreadValues_;
-}
\ No newline at end of file
+	thread_local threadEntries threadValues_;
+	thread_local bool threadValuesAlive_ = false;
+
+	static std::mutex slotsMutex_;
+	// created on first use and never destroyed, since static ThreadLocalValues in other translation units
+	// may allocate and free slots before and after this file's statics live
+	static std::vector<unsigned>& freeSlots() {
+		static std::vector<unsigned>* slots = new std::vector<unsigned>();
+		return *slots;
+	}
+	static unsigned nextSlot_ = 0;
+	static std::atomic<uint64_t> nextGeneration_ { 1 };	// zero is reserved for empty entries
+
+	threadEntries::threadEntries() {
+		threadValuesAlive_ = true;
+	}
+
+	threadEntries::~threadEntries() {
+		threadValuesAlive_ = false;
+		for (unsigned i=0; i<entries.size(); i++)
+			release(i);
+	}
+
+	void threadEntries::release(unsigned slot) {
+		auto &e = entries[slot];
+		if (e.value)
+			e.deleter(e.value);
+		e = entry();
+	}
+
+	void allocSlot(unsigned &outSlot, uint64_t &outGeneration) {
+		outGeneration = nextGeneration_.fetch_add(1, std::memory_order_relaxed);
+		std::lock_guard<std::mutex> lk(slotsMutex_);
+		auto &slots = freeSlots();
+		if (!slots.empty()) {
+			outSlot = slots.back();
+			slots.pop_back();
+		} else
+			outSlot = nextSlot_++;
+	}
+
+	void freeSlot(unsigned slot) {
+		std::lock_guard<std::mutex> lk(slotsMutex_);
+		freeSlots().push_back(slot);
+	}
+}
@@ -7,15 +7,40 @@
 
 #include <boglfw/utils/ThreadPool.h>
 #include <boglfw/utils/assert.h>
+#include <boglfw/utils/cpuTopology.h>
+#include <boglfw/utils/log.h>
 #include <boglfw/perf/marker.h>
 
-ThreadPool::ThreadPool(unsigned numberOfThreads)
+ThreadPool::ThreadPool(unsigned numberOfThreads, ThreadPoolAffinity const& affinity)
+	: workerNode_(numberOfThreads, 0)
+	, workerCounters_(new workerCounters[numberOfThreads])
 {
 #ifdef DEBUG_THREADPOOL
 	LOGLN(__FUNCTION__);
 #endif
+	if (affinity.numaLocalQueues && affinity.mode == ThreadPoolAffinity::PinEachWorker) {
+		// map the NUMA nodes used by our workers to queue indexes
+		auto cpus = affinity.cpus;
+		if (cpus.empty())
+			for (auto &c : CpuTopology::get().getCpus())
+				cpus.push_back(c.cpu);
+		std::vector<unsigned> nodeIds;
+		for (unsigned i=0; i<numberOfThreads; i++) {
+			unsigned node = CpuTopology::get().getNumaNodeOfCpu(cpus[i % cpus.size()]);
+			auto it = std::find(nodeIds.begin(), nodeIds.end(), node);
+			workerNode_[i] = it - nodeIds.begin();
+			if (it == nodeIds.end())
+				nodeIds.push_back(node);
+		}
+		if (nodeIds.size() > 1)
+			nodeQueues_.resize(nodeIds.size());
+		else
+			std::fill(workerNode_.begin(), workerNode_.end(), 0);
+	}
 	for (unsigned i=0; i<numberOfThreads; i++)
-		workers_.push_back(std::thread(std::bind(&ThreadPool::workerFunc, this)));
+		workers_.push_back(std::thread(std::bind(&ThreadPool::workerFunc, this, i)));
+	if (affinity.mode != ThreadPoolAffinity::Floating)
+		setupAffinity(affinity);
 #ifdef DEBUG_THREADPOOL
 	LOGLN(__FUNCTION__ << " finished.");
 #endif
@@ -24,11 +49,57 @@ ThreadPool::~ThreadPool() {
 	assertDbg(stopped_ && "Thread pool has not been stopped before destruction!");
 }
 
-void ThreadPool::wait_impl(std::unique_lock<std::mutex> &poolLk) {
+void ThreadPool::setupAffinity(ThreadPoolAffinity const& affinity) {
+	LOGPREFIX("ThreadPool");
+	auto cpus = affinity.cpus;
+	if (cpus.empty())
+		for (auto &c : CpuTopology::get().getCpus())
+			cpus.push_back(c.cpu);
+	for (unsigned i=0; i<workers_.size(); i++) {
+		bool ok = affinity.mode == ThreadPoolAffinity::PinEachWorker
+			? CpuTopology::setThreadAffinity(workers_[i], {cpus[i % cpus.size()]})
+			: CpuTopology::setThreadAffinity(workers_[i], cpus);
+		if (!ok) {
+			LOGLN("WARNING: failed to set worker thread affinity, workers will float freely.");
+			return;
+		}
+	}
+}
+
+unsigned ThreadPool::getThreadCountOnNode(unsigned node) const {
+	if (nodeQueues_.empty())
+		return workers_.size();
+	return std::count(workerNode_.begin(), workerNode_.end(), node);
+}
+
+PoolTaskHandle ThreadPool::popTask(unsigned workerIndex, bool &outStolen) {
+	outStolen = false;
+	std::queue<PoolTaskHandle> *source = nullptr;
+	if (!nodeQueues_.empty() && !nodeQueues_[workerNode_[workerIndex]].empty())
+		source = &nodeQueues_[workerNode_[workerIndex]];
+	else if (!queuedTasks_.empty())
+		source = &queuedTasks_;
+	else {
+		// nothing for our node, help out the others:
+		for (auto &q : nodeQueues_)
+			if (!q.empty()) {
+				source = &q;
+				outStolen = true;
+				break;
+			}
+	}
+	assertDbg(source != nullptr);
+	PoolTaskHandle task = source->front();
+	source->pop();
+	pendingTasks_--;
+	return task;
+}
+
+void ThreadPool::wait_impl(std::unique_lock<perf::ProfiledMutex> &poolLk) {
 	// wait for all tasks to be processed
 	checkValidState();
 	queueBlocked_.store(true);
-	while (!queuedTasks_.empty()) {
+	while (pendingTasks_ > 0) {
 		poolLk.unlock();
 		std::this_thread::yield();
 		poolLk.lock();
@@ -37,7 +108,7 @@ void ThreadPool::wait_impl(std::unique_lock<std::mutex> &poolLk) {
 }
 
 void ThreadPool::wait() {
-	std::unique_lock<std::mutex> poolLk(poolMutex_);
+	std::unique_lock<perf::ProfiledMutex> poolLk(poolMutex_);
 	wait_impl(poolLk);
 }
 
@@ -45,7 +116,7 @@ void ThreadPool::stop() {
 #ifdef DEBUG_THREADPOOL
 	LOGLN(__FUNCTION__);
 #endif
-	std::unique_lock<std::mutex> poolLk(poolMutex_);
+	std::unique_lock<perf::ProfiledMutex> poolLk(poolMutex_);
 	wait_impl(poolLk);
 	// wait for all workers to finish and shuts down the threads in the pool
 	stopSignal_.store(true);
@@ -56,15 +127,20 @@ void ThreadPool::stop() {
 	stopped_.store(true);
 }
 
-void ThreadPool::workerFunc() {
+void ThreadPool::workerFunc(unsigned workerIndex) {
 	perf::setCrtThreadName("ThreadPoolWorker");
 #ifdef DEBUG_THREADPOOL
 	LOGLN(__FUNCTION__ << " begin");
 #endif
+	workerCounters &counters = workerCounters_[workerIndex];
 	while (!stopSignal_) {
+		bool instrument = instrumentationEnabled_.load(std::memory_order_relaxed);
+		std::chrono::high_resolution_clock::time_point idleStart;
+		if (instrument)
+			idleStart = std::chrono::high_resolution_clock::now();
 		PoolTaskHandle task(nullptr);
-		std::unique_lock<std::mutex> lk(poolMutex_);
-		auto pred = [this] { return stopSignal_ || !!!queuedTasks_.empty(); };
+		std::unique_lock<perf::ProfiledMutex> lk(poolMutex_);
+		auto pred = [this] { return stopSignal_ || pendingTasks_ > 0; };
 		if (!pred()) {
 #ifdef DEBUG_THREADPOOL
 	LOGLN(__FUNCTION__ << " wait for work...");
@@ -76,11 +152,23 @@ void ThreadPool::workerFunc() {
 #endif
 		if (stopSignal_)
 			return;
-		assertDbg(!!!queuedTasks_.empty());
-		task = queuedTasks_.front();
-		queuedTasks_.pop();
+		bool stolen = false;
+		task = popTask(workerIndex, stolen);
 		lk.unlock();
 
+		std::chrono::high_resolution_clock::time_point busyStart;
+		if (instrument) {
+			busyStart = std::chrono::high_resolution_clock::now();
+			counters.idleNanosec.fetch_add(std::chrono::nanoseconds(busyStart - idleStart).count(), std::memory_order_relaxed);
+			if (task->queuedTime_.time_since_epoch().count() != 0) {
+				uint64_t waitNanosec = std::chrono::nanoseconds(busyStart - task->queuedTime_).count();
+				unsigned bucket = 0;
+				while (bucket < waitHistogramBuckets-1 && (waitNanosec >> (bucket+1)))
+					bucket++;
+				counters.waitHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
 		std::lock_guard<std::mutex> workLk(task->workMutex_);
 		task->started_.store(true);
 		// do work...
@@ -88,6 +176,13 @@ void ThreadPool::workerFunc() {
 			task->workFunc_();
 		} while (0);
 		task->finished_.store(true);
+		if (instrument) {
+			auto busyEnd = std::chrono::high_resolution_clock::now();
+			counters.busyNanosec.fetch_add(std::chrono::nanoseconds(busyEnd - busyStart).count(), std::memory_order_relaxed);
+			counters.tasksExecuted.fetch_add(1, std::memory_order_relaxed);
+			if (stolen)
+				counters.tasksStolen.fetch_add(1, std::memory_order_relaxed);
+		}
 #ifdef DEBUG_THREADPOOL
 	LOGLN(__FUNCTION__ << " finished work.");
 #endif
@@ -112,6 +207,47 @@ void PoolTask::wait() {
 #endif
 }
 
+void ThreadPool::recordQueuedTask(PoolTask &task) {
+	task.queuedTime_ = std::chrono::high_resolution_clock::now();
+	uint64_t depth = pendingTasks_;
+	queueDepthSamples_++;
+	queueDepthSum_ += depth;
+	if (depth > queueDepthMax_)
+		queueDepthMax_ = depth;
+}
+
+ThreadPool::Stats ThreadPool::getStats() {
+	Stats stats;
+	for (unsigned i=0; i<workers_.size(); i++) {
+		WorkerStats ws;
+		ws.busyNanosec = workerCounters_[i].busyNanosec.load(std::memory_order_relaxed);
+		ws.idleNanosec = workerCounters_[i].idleNanosec.load(std::memory_order_relaxed);
+		ws.tasksExecuted = workerCounters_[i].tasksExecuted.load(std::memory_order_relaxed);
+		ws.tasksStolen = workerCounters_[i].tasksStolen.load(std::memory_order_relaxed);
+		for (unsigned b=0; b<waitHistogramBuckets; b++)
+			ws.waitHistogram[b] = workerCounters_[i].waitHistogram[b].load(std::memory_order_relaxed);
+		stats.workers.push_back(ws);
+	}
+	std::lock_guard<perf::ProfiledMutex> lk(poolMutex_);
+	stats.queueDepthSamples = queueDepthSamples_;
+	stats.queueDepthSum = queueDepthSum_;
+	stats.queueDepthMax = queueDepthMax_;
+	return stats;
+}
+
+void ThreadPool::resetStats() {
+	for (unsigned i=0; i<workers_.size(); i++) {
+		workerCounters_[i].busyNanosec.store(0, std::memory_order_relaxed);
+		workerCounters_[i].idleNanosec.store(0, std::memory_order_relaxed);
+		workerCounters_[i].tasksExecuted.store(0, std::memory_order_relaxed);
+		workerCounters_[i].tasksStolen.store(0, std::memory_order_relaxed);
+		for (auto &b : workerCounters_[i].waitHistogram)
+			b.store(0, std::memory_order_relaxed);
+	}
+	std::lock_guard<perf::ProfiledMutex> lk(poolMutex_);
+	queueDepthSamples_ = queueDepthSum_ = queueDepthMax_ = 0;
+}
+
 void ThreadPool::checkValidState() {
 	if (stopRequested_)
 		throw std::runtime_error("Invalid operation on thread pool (pool is stopping)");
@@ -0,0 +1,417 @@
+/*
+ * asyncLogger.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/utils/asyncLogger.h>
+#include <boglfw/utils/log.h>
+#include <boglfw/utils/cacheLine.h>
+#include <boglfw/utils/assert.h>
+#include <boglfw/perf/clock.h>
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cstring>
+#include <cstddef>
+
+namespace {
+
+struct recordHeader {
+	uint32_t size;		// total size of the record in the ring, including this header and the padding
+	uint16_t kind;
+	uint16_t flags;
+	uint32_t length;	// length of the text that follows the header
+	uint32_t reserved;
+	int64_t time;		// perf::Clock nanoseconds
+};
+static_assert(sizeof(recordHeader) == 24, "recordHeader must keep the records 8-byte aligned");
+
+// fills the space at the end of the ring when the next record doesn't fit there
+constexpr uint16_t skipRecord = 0xFFFF;
+
+// a thread's ring buffer of variable-sized records; single producer (the owning thread), single consumer (the writer)
+class logRing {
+public:
+	explicit logRing(size_t capacity)
+		: capacity_(roundUpPow2(std::max<size_t>(capacity, 4096)))
+		, mask_(capacity_ - 1)
+		, buffer_(new uint64_t[capacity_ / sizeof(uint64_t)]) {
+	}
+
+	// longer records would take up too much of the ring
+	size_t maxLength() const { return capacity_ / 2 - sizeof(recordHeader); }
+
+	// producer only; returns false if there's no room for the record
+	bool tryPush(uint16_t kind, uint16_t flags, int64_t time, const char* text, size_t length) {
+		assertDbg(length <= maxLength());
+		size_t need = align8(sizeof(recordHeader) + length);
+		uint64_t w = writePos_.load(std::memory_order_relaxed);
+		size_t offset = w & mask_;
+		size_t tail = capacity_ - offset;
+		size_t total = need + (tail < need ? tail : 0);
+		if (capacity_ - (w - cachedReadPos_) < total) {
+			cachedReadPos_ = readPos_.load(std::memory_order_acquire);
+			if (capacity_ - (w - cachedReadPos_) < total)
+				return false;
+		}
+		if (tail < need) {
+			// only the size and kind are read from a skip record, and those fit in the (at least) 8 bytes left
+			uint32_t size = tail;
+			memcpy(bytes() + offset, &size, sizeof(size));
+			memcpy(bytes() + offset + offsetof(recordHeader, kind), &skipRecord, sizeof(skipRecord));
+			w += tail;
+			offset = 0;
+		}
+		recordHeader hdr { (uint32_t)need, kind, flags, (uint32_t)length, 0, time };
+		memcpy(bytes() + offset, &hdr, sizeof(hdr));
+		memcpy(bytes() + offset + sizeof(hdr), text, length);
+		writePos_.store(w + need, std::memory_order_release);
+		return true;
+	}
+
+	// producer only; true if the ring is more than half full
+	bool isFilling() {
+		uint64_t w = writePos_.load(std::memory_order_relaxed);
+		if (w - cachedReadPos_ <= capacity_ / 2)
+			return false;
+		cachedReadPos_ = readPos_.load(std::memory_order_acquire);
+		return w - cachedReadPos_ > capacity_ / 2;
+	}
+
+	// consumer only; calls func(header, text) for each available record
+	template<class F>
+	void drain(F func) {
+		uint64_t r = readPos_.load(std::memory_order_relaxed);
+		uint64_t w = writePos_.load(std::memory_order_acquire);
+		while (r < w) {
+			const char* p = bytes() + (r & mask_);
+			uint32_t size;
+			uint16_t kind;
+			memcpy(&size, p, sizeof(size));
+			memcpy(&kind, p + offsetof(recordHeader, kind), sizeof(kind));
+			if (kind != skipRecord) {
+				recordHeader hdr;
+				memcpy(&hdr, p, sizeof(hdr));
+				func(hdr, p + sizeof(hdr));
+			}
+			r += size;
+		}
+		readPos_.store(r, std::memory_order_release);
+	}
+
+	bool empty() const {
+		return readPos_.load(std::memory_order_acquire) == writePos_.load(std::memory_order_acquire);
+	}
+
+	std::atomic<bool> orphaned { false };	// set when the owning thread exits
+	std::atomic<bool> busy { false };		// set by the owning thread while it is in AsyncLogger::write()
+
+private:
+	const size_t capacity_;
+	const size_t mask_;
+	std::unique_ptr<uint64_t[]> buffer_;
+	cacheLinePadding<std::pair<size_t, size_t>> pad0_;
+
+	// producer side:
+	std::atomic<uint64_t> writePos_ { 0 };
+	uint64_t cachedReadPos_ = 0;
+	cacheLinePadding<std::pair<std::atomic<uint64_t>, uint64_t>> pad1_;
+
+	// consumer side:
+	std::atomic<uint64_t> readPos_ { 0 };
+	cacheLinePadding<std::atomic<uint64_t>> pad2_;
+
+	char* bytes() const { return reinterpret_cast<char*>(buffer_.get()); }
+
+	static size_t align8(size_t x) { return (x + 7) & ~(size_t)7; }
+	static size_t roundUpPow2(size_t x) {
+		size_t p = 1;
+		while (p < x)
+			p <<= 1;
+		return p;
+	}
+};
+
+// a record taken out of the rings, waiting to be written
+struct pendingRecord {
+	int64_t time;
+	uint16_t kind;
+	uint16_t flags;
+	std::string text;
+};
+
+// the ring of the calling thread; it's replaced when the logger is restarted
+struct threadRing {
+	std::shared_ptr<logRing> ring;
+	unsigned generation = 0;
+
+	~threadRing() {
+		if (ring)
+			ring->orphaned.store(true, std::memory_order_release);
+	}
+};
+
+AsyncLoggerConfig config;
+std::atomic<bool> running { false };
+std::atomic<unsigned> generation { 0 };
+std::atomic<uint64_t> droppedCount { 0 };
+thread_local threadRing crtThreadRing;
+thread_local bool onWriterThread = false;
+
+std::mutex ringsMutex;
+std::vector<std::shared_ptr<logRing>> rings;
+
+std::thread writerThread;
+std::mutex wakeMutex;
+std::condition_variable wakeCond;
+std::condition_variable flushDoneCond;
+std::atomic<bool> wakeRequested { false };
+bool stopRequested = false;			// guarded by wakeMutex
+uint64_t flushRequested = 0;		// guarded by wakeMutex
+uint64_t flushCompleted = 0;		// guarded by wakeMutex
+
+// used for converting the record times to wall clock time
+perf::Clock::time_point clockBase;
+std::chrono::system_clock::time_point systemBase;
+
+// consumer-side state (only touched by the writer thread, or by stop() after the writer has exited)
+std::vector<pendingRecord> pending;
+uint64_t reportedDropped = 0;
+
+void wakeWriter() {
+	if (!wakeRequested.load(std::memory_order_relaxed) && !wakeRequested.exchange(true, std::memory_order_acq_rel))
+		wakeCond.notify_one();
+}
+
+void drainRings() {
+	std::lock_guard<std::mutex> lk(ringsMutex);
+	for (auto it = rings.begin(); it != rings.end(); ) {
+		// the orphaned flag must be read before draining, so that nothing is left behind when the ring is removed
+		bool orphaned = (*it)->orphaned.load(std::memory_order_acquire);
+		(*it)->drain([] (recordHeader const& hdr, const char* text) {
+			pending.push_back(pendingRecord { hdr.time, hdr.kind, hdr.flags, std::string(text, hdr.length) });
+		});
+		if (orphaned && (*it)->empty())
+			it = rings.erase(it);
+		else
+			++it;
+	}
+	uint64_t dropped = droppedCount.load(std::memory_order_relaxed);
+	if (dropped != reportedDropped) {
+		pending.push_back(pendingRecord { perf::Clock::now().time_since_epoch().count(), AsyncLogger::LogRecord, 0,
+			"[AsyncLogger] " + std::to_string(dropped - reportedDropped) + " lines dropped (thread buffer full)\n" });
+		reportedDropped = dropped;
+	}
+}
+
+time_t toWallTime(int64_t time) {
+	auto wallTime = systemBase + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+			std::chrono::nanoseconds(time - clockBase.time_since_epoch().count()));
+	return std::chrono::system_clock::to_time_t(wallTime);
+}
+
+// writes out the pending records up to (and including) the given time, in time order
+void writePending(int64_t maxTime) {
+	if (pending.empty())
+		return;
+	// the records of each thread are already in order, so a stable sort keeps the order of lines with equal times
+	std::stable_sort(pending.begin(), pending.end(), [] (pendingRecord const& a, pendingRecord const& b) {
+		return a.time < b.time;
+	});
+	auto end = std::upper_bound(pending.begin(), pending.end(), maxTime, [] (int64_t t, pendingRecord const& r) {
+		return t < r.time;
+	});
+	if (end == pending.begin())
+		return;
+	{
+		std::lock(logger::getLogMutex(), logger::getErrMutex());
+		std::lock_guard<perf::ProfiledMutex> lkL(logger::getLogMutex(), std::adopt_lock);
+		std::lock_guard<perf::ProfiledMutex> lkE(logger::getErrMutex(), std::adopt_lock);
+		std::ostream* logStream = logger::instance().getLogStream();
+		std::ostream* errStream = logger::instance().getErrStream();
+		for (auto it = pending.begin(); it != end; ++it) {
+			auto writeRecord = [&] (std::ostream &stream, const char* marker) {
+				stream << marker;
+				if (!(it->flags & AsyncLogger::NoPrefix))
+					logger::writeTimestamp(stream, toWallTime(it->time));
+				if (it->flags & AsyncLogger::Deferred)
+					formatDeferred(stream, it->text.data(), it->text.size());
+				else
+					stream.write(it->text.data(), it->text.size());
+			};
+			switch (it->kind) {
+			case AsyncLogger::LogRecord:
+				if (logStream)
+					writeRecord(*logStream, "");
+				break;
+			case AsyncLogger::StdoutRecord:
+				writeRecord(std::cout, "");
+				break;
+			case AsyncLogger::ErrorRecord:
+				for (auto stream : {&std::cerr, errStream})
+					if (stream)
+						writeRecord(*stream, "!!!ERROR!!!");
+				break;
+			}
+		}
+		if (logStream)
+			logStream->flush();
+		if (errStream)
+			errStream->flush();
+	}
+	pending.erase(pending.begin(), end);
+}
+
+void writerFunc() {
+	onWriterThread = true;
+	for (;;) {
+		bool stopping;
+		uint64_t flushTarget;
+		{
+			std::unique_lock<std::mutex> lk(wakeMutex);
+			wakeCond.wait_for(lk, std::chrono::milliseconds(config.flushIntervalMs), [] {
+				return stopRequested || flushRequested > flushCompleted || wakeRequested.load();
+			});
+			wakeRequested.store(false);
+			stopping = stopRequested;
+			flushTarget = flushRequested > flushCompleted ? flushRequested : 0;
+		}
+
+		drainRings();
+		if (stopping || flushTarget)
+			writePending(std::numeric_limits<int64_t>::max());
+		else
+			writePending(perf::Clock::now().time_since_epoch().count() - (int64_t)config.reorderWindowMs * 1000000);
+
+		if (flushTarget) {
+			std::lock_guard<std::mutex> lk(wakeMutex);
+			flushCompleted = flushTarget;
+			flushDoneCond.notify_all();
+		}
+		if (stopping)
+			break;
+	}
+}
+
+} // anonymous namespace
+
+void AsyncLogger::start(AsyncLoggerConfig const& cfg) {
+	if (running.load())
+		return;
+	config = cfg;
+	clockBase = perf::Clock::now();
+	systemBase = std::chrono::system_clock::now();
+	stopRequested = false;
+	generation.fetch_add(1, std::memory_order_release);	// threads will create new rings with the new size
+	writerThread = std::thread(writerFunc);
+	running.store(true, std::memory_order_release);
+	logger::async_.store(true, std::memory_order_release);
+}
+
+void AsyncLogger::stop() {
+	if (!running.load())
+		return;
+	// new lines are written synchronously from now on
+	logger::async_.store(false, std::memory_order_release);
+	// must be seq_cst, together with the busy flag protocol in push(); a release store could be reordered after the busy scan below
+	running.store(false, std::memory_order_seq_cst);
+	{
+		std::lock_guard<std::mutex> lk(wakeMutex);
+		stopRequested = true;
+		flushDoneCond.notify_all();
+	}
+	wakeCond.notify_one();
+	writerThread.join();
+	// a thread that entered write() before it could see running == false may still be pushing a record;
+	// any thread that enters from now on sees it and writes synchronously
+	{
+		std::lock_guard<std::mutex> lk(ringsMutex);
+		for (auto &r : rings)
+			while (r->busy.load(std::memory_order_seq_cst))
+				std::this_thread::yield();
+	}
+	// pick up whatever was pushed by threads that were still in write() when the writer stopped
+	drainRings();
+	writePending(std::numeric_limits<int64_t>::max());
+}
+
+bool AsyncLogger::isRunning() {
+	return running.load(std::memory_order_acquire);
+}
+
+void AsyncLogger::flush() {
+	if (!running.load(std::memory_order_acquire) || onWriterThread)
+		return;	// the writer can't wait for itself
+	std::unique_lock<std::mutex> lk(wakeMutex);
+	uint64_t target = ++flushRequested;
+	wakeCond.notify_one();
+	flushDoneCond.wait(lk, [target] { return flushCompleted >= target || stopRequested; });
+}
+
+uint64_t AsyncLogger::getDroppedCount() {
+	return droppedCount.load(std::memory_order_relaxed);
+}
+
+bool AsyncLogger::write(RecordKind kind, uint16_t flags, const char* text, size_t length) {
+	if (!push(kind, flags, text, length))
+		return false;
+	// an error is often followed by a crash (see assertDbg), so it must be out before returning;
+	// flushing rather than writing it here keeps it in order with the lines logged before it
+	if (kind == ErrorRecord)
+		flush();
+	return true;
+}
+
+bool AsyncLogger::push(RecordKind kind, uint16_t flags, const char* text, size_t length) {
+	if (!running.load(std::memory_order_acquire))
+		return false;
+	auto &tr = crtThreadRing;
+	unsigned crtGeneration = generation.load(std::memory_order_acquire);
+	if (!tr.ring || tr.generation != crtGeneration) {
+		if (tr.ring)
+			tr.ring->orphaned.store(true, std::memory_order_release);
+		tr.ring = std::make_shared<logRing>(config.threadBufferSize);
+		tr.generation = crtGeneration;
+		std::lock_guard<std::mutex> lk(ringsMutex);
+		rings.push_back(tr.ring);
+	}
+	if (length > tr.ring->maxLength())
+		return false;	// very long lines are written synchronously
+	// pairs with stop(): either stop() sees the ring busy and waits for the push to finish before its last drain,
+	// or this sees running == false and the line is written synchronously
+	struct busyScope {
+		logRing &ring;
+		explicit busyScope(logRing &r) : ring(r) { ring.busy.store(true, std::memory_order_seq_cst); }
+		~busyScope() { ring.busy.store(false, std::memory_order_release); }
+	} busy(*tr.ring);
+	if (!running.load(std::memory_order_seq_cst))
+		return false;
+	int64_t time = perf::Clock::now().time_since_epoch().count();
+	if (!tr.ring->tryPush(kind, flags, time, text, length)) {
+		if (kind == ErrorRecord)
+			return false;	// errors are never dropped
+		if (config.overflowPolicy == AsyncLoggerConfig::Drop) {
+			droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+		do {
+			wakeWriter();
+			std::this_thread::yield();
+			if (!running.load(std::memory_order_acquire))
+				return false;
+		} while (!tr.ring->tryPush(kind, flags, time, text, length));
+	}
+	if (tr.ring->isFilling())
+		wakeWriter();
+	return true;
+}
@@ -0,0 +1,282 @@
+/*
+ * compression.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/utils/compression.h>
+
+#ifdef WITH_LZ4
+#include <lz4.h>
+#endif
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+/*
+ * FastLZ block format: a sequence of
+ *	token			high 4 bits: number of literals, low 4 bits: match length - 4; 15 means more length bytes follow
+ *	[length bytes]	for the literals: 255 while the remaining length is >= 255, then the remainder
+ *	literals
+ *	offset			2 bytes little endian, the distance back from the current output position (1 ... 65535)
+ *	[length bytes]	for the match, like the ones for the literals
+ * The last sequence only has literals and ends the block.
+ */
+namespace fastLZ {
+
+static constexpr unsigned minMatch = 4;
+static constexpr unsigned maxOffset = 65535;
+static constexpr unsigned hashBits = 14;
+
+static inline uint32_t read32(const uint8_t* p) {
+	uint32_t x;
+	memcpy(&x, p, sizeof(x));
+	return x;
+}
+
+static inline uint64_t read64(const uint8_t* p) {
+	uint64_t x;
+	memcpy(&x, p, sizeof(x));
+	return x;
+}
+
+static inline uint32_t hash(uint32_t sequence) {
+	return (sequence * 2654435761u) >> (32 - hashBits);
+}
+
+static inline void writeLength(uint8_t* &op, size_t length) {
+	for (; length >= 255; length -= 255)
+		*op++ = 255;
+	*op++ = (uint8_t)length;
+}
+
+// matchLength = 0 writes the last sequence
+static bool writeSequence(uint8_t* &op, const uint8_t* oend, const uint8_t* literals, size_t literalLength,
+		size_t offset, size_t matchLength) {
+	size_t needed = 1 + literalLength / 255 + 1 + literalLength + (matchLength ? 2 + matchLength / 255 + 1 : 0);
+	if (needed > (size_t)(oend - op))
+		return false;
+	uint8_t* token = op++;
+	*token = std::min<size_t>(literalLength, 15) << 4;
+	if (literalLength >= 15)
+		writeLength(op, literalLength - 15);
+	if (literalLength)
+		memcpy(op, literals, literalLength);
+	op += literalLength;
+	if (matchLength) {
+		*op++ = offset & 0xff;
+		*op++ = offset >> 8;
+		*token |= std::min<size_t>(matchLength - minMatch, 15);
+		if (matchLength - minMatch >= 15)
+			writeLength(op, matchLength - minMatch - 15);
+	}
+	return true;
+}
+
+static size_t compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity) {
+	uint32_t table[1 << hashBits] {};	// the last position where each hash was seen
+	const uint8_t* ip = src;
+	const uint8_t* anchor = src;		// start of the pending literals
+	const uint8_t* const iend = src + srcSize;
+	uint8_t* op = dst;
+	const uint8_t* const oend = dst + dstCapacity;
+	unsigned misses = 0;
+	while (srcSize >= minMatch && ip <= iend - minMatch) {
+		uint32_t sequence = read32(ip);
+		uint32_t &slot = table[hash(sequence)];
+		const uint8_t* ref = src + slot;
+		slot = (uint32_t)(ip - src);
+		if (ref >= ip || ip - ref > maxOffset || read32(ref) != sequence) {
+			// skip faster through data that doesn't compress
+			ip += 1 + (misses++ >> 6);
+			continue;
+		}
+		const uint8_t* matchEnd = ip + minMatch;
+		ref += minMatch;
+		while (matchEnd + 8 <= iend && read64(matchEnd) == read64(ref))
+			matchEnd += 8, ref += 8;
+		while (matchEnd < iend && *matchEnd == *ref)
+			matchEnd++, ref++;
+		if (!writeSequence(op, oend, anchor, ip - anchor, matchEnd - ref, matchEnd - ip))
+			return 0;
+		ip = anchor = matchEnd;
+		misses = 0;
+	}
+	if (!writeSequence(op, oend, anchor, iend - anchor, 0, 0))
+		return 0;
+	return op - dst;
+}
+
+static inline bool readLength(const uint8_t* &ip, const uint8_t* iend, size_t &length) {
+	uint8_t b;
+	do {
+		if (ip >= iend)
+			return false;
+		b = *ip++;
+		length += b;
+	} while (b == 255);
+	return true;
+}
+
+static bool decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+	const uint8_t* ip = src;
+	const uint8_t* const iend = src + srcSize;
+	uint8_t* op = dst;
+	uint8_t* const oend = dst + dstSize;
+	while (ip < iend) {
+		unsigned token = *ip++;
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && !readLength(ip, iend, literalLength))
+			return false;
+		if (literalLength > (size_t)(iend - ip) || literalLength > (size_t)(oend - op))
+			return false;
+		if (literalLength)
+			memcpy(op, ip, literalLength);
+		op += literalLength;
+		ip += literalLength;
+		if (ip == iend)
+			break;	// the last sequence
+		if (iend - ip < 2)
+			return false;
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !readLength(ip, iend, matchLength))
+			return false;
+		matchLength += minMatch;
+		if (offset == 0 || offset > (size_t)(op - dst) || matchLength > (size_t)(oend - op))
+			return false;
+		const uint8_t* ref = op - offset;
+		if (offset >= 8) {
+			for (; matchLength >= 8; matchLength -= 8, op += 8, ref += 8)
+				memcpy(op, ref, 8);
+		}
+		// the match may overlap the output (runs of a short pattern), so this must go byte by byte
+		while (matchLength--)
+			*op++ = *ref++;
+	}
+	return op == oend;
+}
+
+} // namespace fastLZ
+
+#ifdef WITH_ZSTD
+// reusing the contexts saves allocating their (large) state for every call
+struct zstdContexts {
+	ZSTD_CCtx* compression = ZSTD_createCCtx();
+	ZSTD_DCtx* decompression = ZSTD_createDCtx();
+	~zstdContexts() {
+		ZSTD_freeCCtx(compression);
+		ZSTD_freeDCtx(decompression);
+	}
+};
+static thread_local zstdContexts zstdCtx;
+#endif
+
+bool Compression::isAvailable(CompressionMethod method) {
+	switch (method) {
+	case CompressionMethod::None:
+	case CompressionMethod::FastLZ:
+		return true;
+#ifdef WITH_LZ4
+	case CompressionMethod::LZ4:
+		return true;
+#endif
+#ifdef WITH_ZSTD
+	case CompressionMethod::Zstd:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+CompressionMethod Compression::getPreferred() {
+#if defined(WITH_ZSTD)
+	return CompressionMethod::Zstd;
+#elif defined(WITH_LZ4)
+	return CompressionMethod::LZ4;
+#else
+	return CompressionMethod::FastLZ;
+#endif
+}
+
+const char* Compression::getName(CompressionMethod method) {
+	switch (method) {
+	case CompressionMethod::None: return "none";
+	case CompressionMethod::FastLZ: return "FastLZ";
+	case CompressionMethod::LZ4: return "LZ4";
+	case CompressionMethod::Zstd: return "Zstd";
+	default: return "unknown";
+	}
+}
+
+size_t Compression::maxCompressedSize(CompressionMethod method, size_t size) {
+	switch (method) {
+#ifdef WITH_LZ4
+	case CompressionMethod::LZ4:
+		return size <= LZ4_MAX_INPUT_SIZE ? LZ4_compressBound(size) : 0;
+#endif
+#ifdef WITH_ZSTD
+	case CompressionMethod::Zstd:
+		return ZSTD_compressBound(size);
+#endif
+	case CompressionMethod::FastLZ:
+		return size + size / 255 + 16;
+	default:
+		return size;
+	}
+}
+
+size_t Compression::compress(CompressionMethod method, const void* src, size_t srcSize, void* dst, size_t dstCapacity,
+		int level) {
+	switch (method) {
+	case CompressionMethod::FastLZ:
+		return fastLZ::compress((const uint8_t*)src, srcSize, (uint8_t*)dst, dstCapacity);
+#ifdef WITH_LZ4
+	case CompressionMethod::LZ4:
+		if (srcSize > LZ4_MAX_INPUT_SIZE)
+			return 0;
+		return LZ4_compress_default((const char*)src, (char*)dst, srcSize, std::min<size_t>(dstCapacity, INT_MAX));
+#endif
+#ifdef WITH_ZSTD
+	case CompressionMethod::Zstd: {
+		size_t ret = ZSTD_compressCCtx(zstdCtx.compression, dst, dstCapacity, src, srcSize, level);
+		return ZSTD_isError(ret) ? 0 : ret;
+	}
+#endif
+	default:
+		return 0;
+	}
+}
+
+bool Compression::decompress(CompressionMethod method, const void* src, size_t srcSize, void* dst, size_t dstSize) {
+	switch (method) {
+	case CompressionMethod::None:
+		if (srcSize != dstSize)
+			return false;
+		memcpy(dst, src, srcSize);
+		return true;
+	case CompressionMethod::FastLZ:
+		return fastLZ::decompress((const uint8_t*)src, srcSize, (uint8_t*)dst, dstSize);
+#ifdef WITH_LZ4
+	case CompressionMethod::LZ4:
+		if (srcSize > INT_MAX || dstSize > INT_MAX)
+			return false;
+		return LZ4_decompress_safe((const char*)src, (char*)dst, srcSize, dstSize) == (int)dstSize;
+#endif
+#ifdef WITH_ZSTD
+	case CompressionMethod::Zstd: {
+		size_t ret = ZSTD_decompressDCtx(zstdCtx.decompression, dst, dstSize, src, srcSize);
+		return !ZSTD_isError(ret) && ret == dstSize;
+	}
+#endif
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,156 @@
+/*
+ * cpuTopology.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/utils/cpuTopology.h>
+#include <boglfw/utils/strManip.h>
+#include <boglfw/utils/log.h>
+
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// parses a Linux cpu list such as "0-3,8,10-11"
+static std::vector<unsigned> parseCpuList(std::string const& list) {
+	std::vector<unsigned> ret;
+	for (auto &range : strSplit(list, ',')) {
+		auto bounds = strSplit(range, '-');
+		if (bounds.empty() || bounds[0].empty())
+			continue;
+		unsigned first = std::stoul(bounds[0]);	// may throw std::logic_error on an unexpected format
+		unsigned last = bounds.size() > 1 ? std::stoul(bounds[1]) : first;
+		for (unsigned i=first; i<=last; i++)
+			ret.push_back(i);
+	}
+	return ret;
+}
+
+static bool readSysFile(std::string const& path, std::string &out) {
+	std::ifstream f(path);
+	if (!f.is_open())
+		return false;
+	std::getline(f, out);
+	return true;
+}
+
+CpuTopology const& CpuTopology::get() {
+	static CpuTopology instance;
+	return instance;
+}
+
+CpuTopology::CpuTopology() {
+	std::string line;
+#ifdef __linux__
+	try {
+		if (readSysFile("/sys/devices/system/cpu/online", line)) {
+			for (unsigned cpu : parseCpuList(line)) {
+				std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+				CpuInfo info {cpu, cpu, 0, 0};
+				if (readSysFile(base + "core_id", line))
+					info.core = std::stoul(line);
+				if (readSysFile(base + "physical_package_id", line))
+					info.package = std::stoul(line);
+				cpus_.push_back(info);
+			}
+			// NUMA nodes list their CPUs, not the other way around:
+			if (readSysFile("/sys/devices/system/node/online", line)) {
+				for (unsigned node : parseCpuList(line)) {
+					std::string nodeCpus;
+					if (!readSysFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", nodeCpus))
+						continue;
+					for (unsigned cpu : parseCpuList(nodeCpus))
+						for (auto &c : cpus_)
+							if (c.cpu == cpu)
+								c.numaNode = node;
+				}
+			}
+		}
+	} catch (std::logic_error &e) {
+		// std::stoul() on a /sys file in an unexpected format; fall back to no topology below
+		LOGPREFIX("CpuTopology");
+		LOGLN("WARNING: could not parse the CPU topology (" << e.what() << "), assuming a flat one");
+		cpus_.clear();
+	}
+#endif
+	if (cpus_.empty()) {
+		unsigned n = std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned i=0; i<n; i++)
+			cpus_.push_back(CpuInfo{i, i, 0, 0});
+	}
+	std::sort(cpus_.begin(), cpus_.end(), [] (CpuInfo const& x, CpuInfo const& y) {
+		if (x.numaNode != y.numaNode)
+			return x.numaNode < y.numaNode;
+		if (x.package != y.package)
+			return x.package < y.package;
+		if (x.core != y.core)
+			return x.core < y.core;
+		return x.cpu < y.cpu;
+	});
+	for (auto &c : cpus_) {
+		if (std::find(packages_.begin(), packages_.end(), c.package) == packages_.end())
+			packages_.push_back(c.package);
+		if (std::find(numaNodes_.begin(), numaNodes_.end(), c.numaNode) == numaNodes_.end())
+			numaNodes_.push_back(c.numaNode);
+	}
+	std::sort(packages_.begin(), packages_.end());
+	LOGPREFIX("CpuTopology");
+	LOGLN(cpus_.size() << " CPUs on " << packages_.size() << " package(s), " << numaNodes_.size() << " NUMA node(s)");
+}
+
+std::vector<unsigned> CpuTopology::getCpusOnPackage(unsigned package) const {
+	std::vector<unsigned> ret;
+	for (auto &c : cpus_)
+		if (c.package == package)
+			ret.push_back(c.cpu);
+	return ret;
+}
+
+std::vector<unsigned> CpuTopology::getCpusOnNumaNode(unsigned node) const {
+	std::vector<unsigned> ret;
+	for (auto &c : cpus_)
+		if (c.numaNode == node)
+			ret.push_back(c.cpu);
+	return ret;
+}
+
+unsigned CpuTopology::getNumaNodeOfCpu(unsigned cpu) const {
+	for (auto &c : cpus_)
+		if (c.cpu == cpu)
+			return c.numaNode;
+	return 0;
+}
+
+#ifdef __linux__
+static bool setAffinity(pthread_t handle, std::vector<unsigned> const& cpus) {
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (unsigned c : cpus)
+		CPU_SET(c, &set);
+	return pthread_setaffinity_np(handle, sizeof(set), &set) == 0;
+}
+#endif
+
+bool CpuTopology::setThreadAffinity(std::thread &thread, std::vector<unsigned> const& cpus) {
+#ifdef __linux__
+	return setAffinity(thread.native_handle(), cpus);
+#else
+	return false;
+#endif
+}
+
+bool CpuTopology::setCurrentThreadAffinity(std::vector<unsigned> const& cpus) {
+#ifdef __linux__
+	return setAffinity(pthread_self(), cpus);
+#else
+	return false;
+#endif
+}
@@ -14,17 +14,19 @@
 #include <iomanip>
 #include <iostream>
 #include <deque>
+#include <algorithm>
+#include <cstring>
 
 thread_local logger theInstance;
 thread_local logger& logger::instance_ { theInstance };
 std::atomic<std::ostream*> logger::pLogStream_ { &std::cout };
 std::atomic<std::ostream*> logger::pErrStream_ { nullptr };
-std::mutex logger::logMutex_;
-std::mutex logger::errMutex_;
+perf::ProfiledMutex logger::logMutex_ { "logger::logMutex_" };
+perf::ProfiledMutex logger::errMutex_ { "logger::errMutex_" };
 std::atomic_int logger::logLevel_ { LOG_LEVEL_INFO };
+std::atomic<bool> logger::async_ { false };
 
-std::string formatCrtDateTime() {
-	time_t t = time(0);   // get time now
+std::string formatDateTime(time_t t) {
 	struct tm * now = localtime( & t );
 	// output date & time in this format: "yyyy-mm-dd hh:mm:ss"
 	std::stringstream s;
@@ -38,17 +40,112 @@ std::string formatCrtDateTime() {
 	return s.str();
 }
 
+std::string formatCrtDateTime() {
+	return formatDateTime(time(0));
+}
+
+void logger::writeTimestamp(std::ostream &stream, time_t t) {
+	// formatting the date is slow compared to the rest of the line, so each thread keeps the last one
+	thread_local time_t cachedTime = 0;
+	thread_local std::string cached;
+	if (t != cachedTime || cached.empty()) {
+		cached = "{" + formatDateTime(t) + "} ";
+		cachedTime = t;
+	}
+	stream.write(cached.data(), cached.size());
+}
+
 void logger::writeprefix(std::ostream &stream) {
 	// 1. write timestamp
-	stream << "{" << formatCrtDateTime() << "} ";
+	writeTimestamp(stream, time(0));
 
 	// 2. write logger name:
-	if (prefix_.size())
-		stream << "[";
-	for (unsigned i=0, n=prefix_.size(); i<n; i++)
-		stream << (i==0 ? "" : "::") << prefix_[i];
-	if (prefix_.size())
-		stream << "] ";
+	writeNames(stream);
+}
+
+void logger::writeNames(std::ostream &stream) {
+	if (!prefixDepth_)
+		return;
+	// straight to the buffer, this runs for every line
+	auto &buf = *stream.rdbuf();
+	buf.sputc('[');
+	for (unsigned i=0, n=prefixDepth_ < maxPrefixDepth ? prefixDepth_ : maxPrefixDepth; i<n; i++) {
+		if (i > 0)
+			buf.sputn("::", 2);
+		buf.sputn(prefix_[i], strlen(prefix_[i]));
+	}
+	buf.sputn("] ", 2);
+}
+
+// writes the text of the line in the buffer
+static void writeLineText(std::ostream &stream, logLineBuffer const& buf, uint16_t flags) {
+	if (flags & AsyncLogger::Deferred)
+		formatDeferred(stream, buf.data(), buf.length());
+	else
+		stream.write(buf.data(), buf.length());
+}
+
+void logger::endRecord(AsyncLogger::RecordKind kind, uint16_t flags) {
+	if (AsyncLogger::write(kind, flags, lineBuf_.data(), lineBuf_.length()))
+		return;
+	// the writer couldn't take it, so write it here; the line already contains the logger name
+	time_t t = time(0);
+	bool writePrefix = !(flags & AsyncLogger::NoPrefix);
+	switch (kind) {
+	case AsyncLogger::LogRecord: {
+		std::lock_guard<perf::ProfiledMutex> lk(logMutex_);
+		if (auto stream = getLogStream()) {
+			if (writePrefix)
+				writeTimestamp(*stream, t);
+			writeLineText(*stream, lineBuf_, flags);
+		}
+		break;
+	}
+	case AsyncLogger::StdoutRecord: {
+		std::lock(logMutex_, errMutex_);
+		std::lock_guard<perf::ProfiledMutex> lkL(logMutex_, std::adopt_lock);
+		std::lock_guard<perf::ProfiledMutex> lkE(errMutex_, std::adopt_lock);
+		writeTimestamp(std::cout, t);
+		writeLineText(std::cout, lineBuf_, flags);
+		break;
+	}
+	case AsyncLogger::ErrorRecord: {
+		std::lock_guard<perf::ProfiledMutex> lk(errMutex_);
+		for (auto stream : {&std::cerr, getErrStream()}) {
+			if (!stream)
+				continue;
+			*stream << "!!!ERROR!!!";
+			writeTimestamp(*stream, t);
+			writeLineText(*stream, lineBuf_, flags);
+		}
+		break;
+	}
+	}
+}
+
+void logLineBuffer::grow(size_t extra) {
+	size_t used = length();
+	buf_.resize(std::max<size_t>(256, 2 * (used + extra)));
+	setp(buf_.data(), buf_.data() + buf_.size());
+	pbump(used);
+}
+
+logLineBuffer::int_type logLineBuffer::overflow(int_type c) {
+	if (traits_type::eq_int_type(c, traits_type::eof()))
+		return traits_type::not_eof(c);
+	if (pptr() == epptr())
+		grow(1);
+	*pptr() = traits_type::to_char_type(c);
+	pbump(1);
+	return c;
+}
+
+std::streamsize logLineBuffer::xsputn(const char* s, std::streamsize n) {
+	if (epptr() - pptr() < n)
+		grow(n);
+	std::copy(s, s + n, pptr());
+	pbump(n);
+	return n;
 }
 
 #endif // _ENABLE_LOGGING_
@@ -0,0 +1,95 @@
+/*
+ * logFormat.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#include <boglfw/utils/logFormat.h>
+
+#include <cstring>
+
+namespace {
+
+struct argView {
+	logArgs::argType type;
+	union {
+		int64_t i;
+		uint64_t u;
+		double d;
+		bool b;
+		char c;
+		const void* p;
+	};
+	const char* str;
+	uint32_t strLength;
+};
+
+template<class T>
+T getRaw(const char* &p) {
+	T value;
+	memcpy(&value, p, sizeof(value));
+	p += sizeof(value);
+	return value;
+}
+
+void writeArg(std::ostream &out, argView const& a) {
+	switch (a.type) {
+	case logArgs::Int: out << a.i; break;
+	case logArgs::UInt: out << a.u; break;
+	case logArgs::Double: out << a.d; break;
+	case logArgs::Bool: out << (a.b ? "true" : "false"); break;
+	case logArgs::Char: out << a.c; break;
+	case logArgs::String: out.write(a.str, a.strLength); break;
+	case logArgs::Pointer: out << a.p; break;
+	}
+}
+
+} // anonymous namespace
+
+void formatDeferred(std::ostream &out, const char* data, size_t length) {
+	const char* p = data;
+	const char* end = data + length;
+	auto fmt = getRaw<const logFormat*>(p);
+	unsigned argCount = (uint8_t)*p++;
+	argView args[logArgs::maxArgs];
+	for (unsigned i=0; i<argCount; i++) {
+		args[i].type = (logArgs::argType)*p++;
+		switch (args[i].type) {
+		case logArgs::Int: args[i].i = getRaw<int64_t>(p); break;
+		case logArgs::UInt: args[i].u = getRaw<uint64_t>(p); break;
+		case logArgs::Double: args[i].d = getRaw<double>(p); break;
+		case logArgs::Bool: args[i].b = *p++ != 0; break;
+		case logArgs::Char: args[i].c = *p++; break;
+		case logArgs::Pointer: args[i].p = getRaw<const void*>(p); break;
+		case logArgs::String:
+			args[i].strLength = getRaw<uint32_t>(p);
+			args[i].str = p;
+			p += args[i].strLength;
+			break;
+		}
+	}
+	// the rest is the logger names
+	out.write(p, end - p);
+
+	unsigned crtArg = 0;
+	const char* f = fmt->format;
+	while (const char* placeholder = strstr(f, "{}")) {
+		out.write(f, placeholder - f);
+		if (crtArg < argCount)
+			writeArg(out, args[crtArg++]);
+		else
+			out << "{}";
+		f = placeholder + 2;
+	}
+	// arguments without a placeholder go before the end of the line
+	size_t tail = strlen(f);
+	bool newLine = tail && f[tail-1] == '\n';
+	out.write(f, tail - newLine);
+	for (; crtArg < argCount; crtArg++) {
+		out << " ";
+		writeArg(out, args[crtArg]);
+	}
+	if (newLine)
+		out << "\n";
+}
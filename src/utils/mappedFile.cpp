@@ -0,0 +1,126 @@
+/*
+ * mappedFile.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bog
+ */
+
+#ifdef __WIN32__
+// wingdi.h would define ERROR, which clashes with our logging macro
+#define NOGDI
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#include <boglfw/utils/mappedFile.h>
+#include <boglfw/utils/log.h>
+
+#include <algorithm>
+
+#ifdef __WIN32__
+
+bool MappedFile::open(std::string const& path) {
+	LOGPREFIX("MappedFile");
+	close();
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		ERROR(GetLastError() << ": Could not open file \"" << path << "\"");
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		ERROR("Could not map empty or unreadable file \"" << path << "\"");
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!view) {
+		ERROR(GetLastError() << ": Could not map file \"" << path << "\"");
+		if (mapping)
+			CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	fileHandle_ = file;
+	mappingHandle_ = mapping;
+	data_ = static_cast<const char*>(view);
+	size_ = fileSize.QuadPart;
+	return true;
+}
+
+void MappedFile::close() {
+	if (data_)
+		UnmapViewOfFile(data_);
+	if (mappingHandle_)
+		CloseHandle(mappingHandle_);
+	if (fileHandle_)
+		CloseHandle(fileHandle_);
+	data_ = nullptr;
+	mappingHandle_ = fileHandle_ = nullptr;
+	size_ = 0;
+}
+
+// the pages are read on demand either way
+void MappedFile::prefetch(size_t, size_t) const {
+}
+
+void MappedFile::adviseSequential() const {
+}
+
+#else
+
+bool MappedFile::open(std::string const& path) {
+	LOGPREFIX("MappedFile");
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY, 0);
+	if (fd < 0) {
+		ERROR(errno << ": Could not open file \"" << path << "\"");
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) < 0 || st.st_size == 0) {
+		ERROR("Could not map empty or unreadable file \"" << path << "\"");
+		::close(fd);
+		return false;
+	}
+	void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping keeps its own reference to the file
+	::close(fd);
+	if (addr == MAP_FAILED) {
+		ERROR(errno << ": Could not map file \"" << path << "\"");
+		return false;
+	}
+	data_ = static_cast<const char*>(addr);
+	size_ = st.st_size;
+	return true;
+}
+
+void MappedFile::close() {
+	if (data_)
+		munmap(const_cast<char*>(data_), size_);
+	data_ = nullptr;
+	size_ = 0;
+}
+
+void MappedFile::prefetch(size_t offset, size_t length) const {
+	if (!data_ || offset >= size_)
+		return;
+	length = std::min(length, size_ - offset);
+	// madvise wants a page aligned address
+	static const size_t pageSize = sysconf(_SC_PAGESIZE);
+	size_t alignedOffset = offset - offset % pageSize;
+	madvise(const_cast<char*>(data_) + alignedOffset, length + offset - alignedOffset, MADV_WILLNEED);
+}
+
+void MappedFile::adviseSequential() const {
+	if (data_)
+		madvise(const_cast<char*>(data_), size_, MADV_SEQUENTIAL);
+}
+
+#endif